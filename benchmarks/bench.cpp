@@ -1,19 +1,62 @@
+#include "akl_toussaint.hpp"
+#include "batch_hull.hpp"
+#include "chan.hpp"
 #include "common.hpp"
+#include "dynamic_hull.hpp"
+#include "generate.hpp"
 #include "graham_scan.hpp"
+#include "incremental_hull.hpp"
+#include "perf_counters.hpp"
 #include "quickhull.hpp"
+#include "sharded_hull.hpp"
 #include "marriage_before_conquest.hpp"
+#include "point_file.hpp"
+#include "predicates.hpp"
+#include "simd.hpp"
+#include "sliding_window_hull.hpp"
 #include "util.hpp"
+#include <algorithm>
+#include <cmath>
 #include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <random>
 #include <sstream>
 #include <vector>
 
+/* Heap allocations of the calling thread, read by bench_into to check that
+ * compute_into does not allocate once warm. The counter is thread local, so
+ * the other benchmarks only pay a plain increment. */
+static thread_local size_t allocations = 0;
+
+// out of line like the library ones: once inlined, gcc would pair the
+// malloc() and free() inside them with the operator of the other side
+__attribute__((noinline)) void *operator new(size_t size) {
+  ++allocations;
+  if (void *p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+  std::free(p);
+}
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept {
+  std::free(p);
+}
+
 typedef enum {
   Circle = 0,
   Parabola = 1,
   Square = 2,
 } Shape;
 
-std::vector<Point> read_points(Shape shape, int size) {
+std::string points_path(Shape shape, int size) {
   std::stringstream s;
   s << "build/tests/";
   switch (shape) {
@@ -28,20 +71,551 @@ std::vector<Point> read_points(Shape shape, int size) {
     break;
   }
   s << size;
+  return s.str();
+}
+
+/* The input of a shape, generated in process: the files of
+ * vis/generate_tests.py are only read by the loading benchmarks */
+std::vector<Point> read_points(Shape shape, int size) {
+  switch (shape) {
+  case Circle:
+    return gen::generate(gen::Distribution::Disk, size);
+  case Parabola:
+    return gen::generate(gen::Distribution::Parabola, size);
+  case Square:
+    break;
+  }
+  return gen::generate(gen::Distribution::Square, size);
+}
+
+/* Loading cost of an input: text parse or mapping of the binary file. The
+ * mapped points are summed so that every page is actually read. */
+void bench_load(benchmark::State &state, bool binary, Shape shape) {
+  const std::string path = points_path(shape, state.range());
+  if (!std::filesystem::exists(path)) {
+    state.SkipWithError("no input file, run vis/generate_tests.py");
+    return;
+  }
+  if (binary && !util::is_point_file(path + ".bin")) {
+    state.SkipWithError("no binary file, run `just convert`");
+    return;
+  }
+
+  size_t count = 0;
+  for (auto _ : state) {
+    if (binary) {
+      util::MappedPoints mapped(path + ".bin");
+      float sum = 0;
+      for (const auto &p : mapped.points()) {
+        sum += p.x;
+      }
+      benchmark::DoNotOptimize(sum);
+      count = mapped.points().size();
+    } else {
+      std::vector<Point> points;
+      util::read_points_from_file(path, points);
+      benchmark::DoNotOptimize(points.data());
+      count = points.size();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+/* Online hull: the points are inserted one at a time, in file order, and the
+ * hull is exported once at the end. Items are insertions. */
+void bench_incremental(benchmark::State &state, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+
+  PerfRegion perf(state, points.size());
+  for (auto _ : state) {
+    IncrementalHull hull;
+    for (const auto &p : points) {
+      hull.insert(p);
+    }
+    benchmark::DoNotOptimize(hull.hull());
+  }
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/* Fully dynamic hull: the points are inserted up front, then every iteration
+ * removes a random one and puts it back, so that the hull changes whenever it
+ * is a vertex. Items are updates, two per iteration; compare with bench/quick
+ * for recomputing the hull after each change. */
+void bench_dynamic(benchmark::State &state, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+  DynamicHull hull;
+  for (const auto &p : points) {
+    hull.insert(p);
+  }
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> pick(0, points.size() - 1);
+
+  for (auto _ : state) {
+    const Point &p = points[pick(gen)];
+    hull.erase(p);
+    hull.insert(p);
+    benchmark::DoNotOptimize(hull.size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+/* Sliding window over a stream of 2^19 points: range() is the window size W.
+ * Every iteration pushes the next point, which drops the oldest one; with
+ * `recompute` the window is copied and its hull computed by QuickHull, as
+ * for a full compute per tick. Items are window updates. */
+void bench_window(benchmark::State &state, bool recompute, Shape shape) {
+  const std::vector<Point> stream = read_points(shape, 524288);
+  const size_t width = state.range();
+  SlidingWindowHull sliding(width);
+  std::deque<Point> window;
+  size_t next = 0;
+  for (; next < width; ++next) {
+    sliding.push_back(stream[next]);
+    window.push_back(stream[next]);
+  }
+
+  for (auto _ : state) {
+    const Point &p = stream[next++ % stream.size()];
+    if (recompute) {
+      window.pop_front();
+      window.push_back(p);
+      const Points copy(window.begin(), window.end());
+      benchmark::DoNotOptimize(QuickHullNS::QuickHull().compute(copy));
+    } else {
+      sliding.push_back(p);
+      benchmark::DoNotOptimize(sliding.size());
+    }
+  }
 
-  std::vector<Point> res;
-  util::read_points_from_file(s.str(), res);
-  return res;
+  state.SetItemsProcessed(state.iterations());
 }
 
-template <typename T>
-void bench(benchmark::State &state, ConvexHull<T> const& algo, Shape shape) {
+/* Text parse throughput: the stream reader or parse_points_file, range(0) is
+ * the number of points and range(1) the number of parsing threads */
+void bench_parse(benchmark::State &state, bool stream, Shape shape) {
+  const std::string path = points_path(shape, state.range(0));
+  const unsigned threads = state.range(1);
+  if (!std::filesystem::exists(path)) {
+    state.SkipWithError("no input file, run vis/generate_tests.py");
+    return;
+  }
+
+  for (auto _ : state) {
+    Points points;
+    if (stream) {
+      std::ifstream file(path);
+      util::read_points_from_stream(file, points);
+    } else {
+      util::parse_points_file(path, points, threads);
+    }
+    benchmark::DoNotOptimize(points.data());
+  }
+
+  state.SetBytesProcessed(state.iterations() *
+                          std::filesystem::file_size(path));
+}
+
+/* Hull straight from the mapped binary file, without copying the input */
+template <typename Algo>
+void bench_mapped(benchmark::State &state, Algo const &algo, Shape shape) {
+  const std::string path = points_path(shape, state.range()) + ".bin";
+  if (!util::is_point_file(path)) {
+    state.SkipWithError("no binary file, run `just convert`");
+    return;
+  }
+  util::MappedPoints mapped(path);
+
+  PerfRegion perf(state, mapped.points().size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(algo.compute(mapped.points()));
+}
+
+template <typename Algo>
+void bench(benchmark::State &state, Algo const& algo, Shape shape) {
   std::vector<Point> points = read_points(shape, state.range());
 
+  PerfRegion perf(state, points.size());
   for (auto _ : state)
     benchmark::DoNotOptimize(algo.compute(points));
 }
 
+/* Akl-Toussaint wrapped algorithms also report how many points the filter
+ * removed before running the inner algorithm */
+void bench(benchmark::State &state, AklToussaint<Points> const &algo,
+           Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+
+  {
+    PerfRegion perf(state, points.size());
+    for (auto _ : state)
+      benchmark::DoNotOptimize(algo.compute(points));
+  }
+
+  state.counters["removed"] = points.size() - algo.filter(points).size();
+}
+
+/* Same algorithm fed with the structure of arrays layout; the conversion is
+ * done once, outside of the timed loop */
+template <typename Algo> struct SoAInput {
+  Algo algo;
+};
+
+template <typename Algo>
+void bench(benchmark::State &state, SoAInput<Algo> const &input, Shape shape) {
+  PointsSoA points(read_points(shape, state.range()));
+
+  PerfRegion perf(state, points.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(input.algo.compute(points));
+}
+
+/* compute_into with a workspace and an output reused by every iteration,
+ * after a warm-up call. The allocations counter is the average number of
+ * allocations per call: 0 for the algorithms that are allocation free. */
+template <typename Algo>
+void bench_into(benchmark::State &state, Algo const &algo, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+  Workspace workspace;
+  Points hull;
+  algo.compute_into(points, hull, workspace);
+
+  PerfRegion perf(state, points.size());
+  size_t allocated = 0;
+  for (auto _ : state) {
+    const size_t before = allocations;
+    algo.compute_into(points, hull, workspace);
+    allocated += allocations - before;
+    benchmark::DoNotOptimize(hull.data());
+  }
+
+  state.counters["allocations"] =
+      benchmark::Counter(static_cast<double>(allocated),
+                         benchmark::Counter::kAvgIterations);
+}
+
+template <typename Algo>
+AklToussaint<Points> akl(int directions = 8) {
+  return AklToussaint<Points>(std::make_shared<VirtualHull<Algo>>(), directions);
+}
+
+template <typename Algo>
+std::unique_ptr<ConvexHull<Points>> make_parallel(unsigned threads) {
+  return std::make_unique<VirtualHull<Algo>>(threads);
+}
+
+/* Benchmark of a parallel algorithm, range(0) is the number of points and
+ * range(1) the number of threads */
+void bench_threads(benchmark::State &state,
+                   std::unique_ptr<ConvexHull<Points>> (*make)(unsigned),
+                   Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range(0));
+  auto algo = make(state.range(1));
+
+  PerfRegion perf(state, points.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(algo->compute(points));
+}
+
+/* Hull of a generated distribution, up to 2^26 points. The "hull" counter is
+ * the number of hull vertices, from a first untimed run. */
+template <typename Algo>
+void bench_generated(benchmark::State &state, Algo const &algo,
+                     gen::Distribution distribution) {
+  const std::vector<Point> points = gen::generate(distribution, state.range());
+  state.counters["hull"] = algo.compute(points).size();
+
+  PerfRegion perf(state, points.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(algo.compute(points));
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/* ShardedHull around the algorithm of `make`, range(0) is the number of
+ * points and range(1) the number of threads. The "speedup" counter is the
+ * wall time of the algorithm alone over that of the sharded one. */
+void bench_sharded(benchmark::State &state,
+                   std::shared_ptr<ConvexHull<Points>> (*make)(),
+                   ShardMerge merge, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range(0));
+  const std::shared_ptr<ConvexHull<Points>> inner = make();
+  const ShardedHull algo(inner, state.range(1), merge);
+
+  const int runs = 5;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++) {
+    benchmark::DoNotOptimize(inner->compute(points));
+  }
+  const std::chrono::duration<double> serial =
+      std::chrono::steady_clock::now() - start;
+
+  PerfRegion perf(state, points.size());
+  const auto loop = std::chrono::steady_clock::now();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(algo.compute(points));
+  const std::chrono::duration<double> sharded =
+      std::chrono::steady_clock::now() - loop;
+  state.counters["speedup"] = serial.count() / runs /
+                              (sharded.count() / state.iterations());
+}
+
+/* 2^16 sets of 5 to 50 uniform points, as in the random loop of main */
+PointSets small_sets() {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> size(5, 50);
+  std::uniform_real_distribution<float> coordinate(-10, 10);
+  PointSets sets;
+  Points set;
+  for (int i = 0; i < 1 << 16; i++) {
+    set.resize(size(gen));
+    for (auto &p : set) {
+      p = Point(coordinate(gen), coordinate(gen));
+    }
+    sets.add(PointsView(set));
+  }
+  return sets;
+}
+
+/* Tiny sets one call at a time, where the cost of the call itself shows:
+ * through the type of the algorithm (its HullAlgorithm interface), or
+ * through ConvexHull like a caller that picks the algorithm at run time */
+template <typename Compute>
+void run_small_sets(benchmark::State &state, Compute compute) {
+  const PointSets sets = small_sets();
+  std::vector<Points> inputs;
+  for (size_t i = 0; i < sets.size(); i++) {
+    inputs.push_back(sets[i].to_aos());
+  }
+
+  for (auto _ : state) {
+    for (const auto &input : inputs) {
+      benchmark::DoNotOptimize(compute(input));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * sets.size());
+}
+
+/* Algo behind ConvexHull, the way a caller picking it at run time holds it */
+template <typename Algo>
+std::shared_ptr<ConvexHull<Points>> virtual_hull() {
+  return std::make_shared<VirtualHull<Algo>>();
+}
+
+template <typename Algo>
+void bench_small_sets(benchmark::State &state, Algo const &algo) {
+  run_small_sets(state, [&algo](const Points &input) {
+    return algo.compute(input);
+  });
+}
+
+void bench_small_sets(benchmark::State &state,
+                      std::shared_ptr<ConvexHull<Points>> algo) {
+  run_small_sets(state, [&algo](const Points &input) {
+    return algo->compute(input);
+  });
+}
+
+/* The same sets through BatchHull, range() is the number of threads */
+void bench_batch(benchmark::State &state) {
+  const PointSets sets = small_sets();
+  const BatchHull batch(state.range());
+  PointSets hulls;
+
+  for (auto _ : state) {
+    batch.compute(sets, hulls);
+    benchmark::DoNotOptimize(hulls.points.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * sets.size());
+}
+
+/* Kernels of the linear passes at a given SIMD level */
+void bench_extremes(benchmark::State &state, simd::Level level, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+  simd::set_level(level);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(util::findExtremePointsCases(points));
+
+  state.SetLabel(simd::level_name(simd::level()));
+  state.SetItemsProcessed(state.iterations() * points.size());
+  simd::set_level(simd::detected_level());
+}
+
+void bench_farthest(benchmark::State &state, simd::Level level, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+  Line l = util::findExtremePoints(points);
+  simd::set_level(level);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        simd::farthest(points.data(), points.size(), l.p1, l.p2));
+
+  state.SetLabel(simd::level_name(simd::level()));
+  state.SetItemsProcessed(state.iterations() * points.size());
+  simd::set_level(simd::detected_level());
+}
+
+/* Orientation of consecutive triples of points, on the square file or on
+ * exactly collinear points, whose rounded cross product of 0 the filter
+ * cannot certify: the rounded double cross product, the filtered
+ * util::orientation and the exact fallback alone. Items are predicates, and
+ * `uncertain` is the share of triples that go to the fallback. */
+enum class Predicate { Rounded, Filtered, Exact };
+
+void bench_predicates(benchmark::State &state, Predicate predicate,
+                      bool collinear) {
+  std::vector<Point> points;
+  if (collinear) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> along(0, 1 << 20);
+    for (int i = 0; i < state.range(); i++) {
+      const int k = along(gen);
+      points.emplace_back(k, 3 * k + 1);
+    }
+  } else {
+    points = read_points(Square, state.range());
+  }
+
+  const auto rounded = [](const Point &a, const Point &b, const Point &c) {
+    return (double(c.x) - b.x) * (double(a.y) - b.y) -
+           (double(c.y) - b.y) * (double(a.x) - b.x);
+  };
+  size_t uncertain = 0;
+  for (size_t i = 2; i < points.size(); i++) {
+    const Point &a = points[i - 2], &b = points[i - 1], &c = points[i];
+    const double left = (double(c.x) - b.x) * (double(a.y) - b.y);
+    const double right = (double(c.y) - b.y) * (double(a.x) - b.x);
+    uncertain += std::abs(left - right) <
+                 util::cross_error_bound * (std::abs(left) + std::abs(right));
+  }
+
+  for (auto _ : state) {
+    size_t left = 0;
+    for (size_t i = 2; i < points.size(); i++) {
+      const Point &a = points[i - 2], &b = points[i - 1], &c = points[i];
+      double side = 0;
+      switch (predicate) {
+      case Predicate::Rounded:
+        side = rounded(a, b, c);
+        break;
+      case Predicate::Filtered:
+        side = util::orientation(a, b, c);
+        break;
+      case Predicate::Exact:
+        side = util::exact_cross(b, c, b, a);
+        break;
+      }
+      left += side > 0;
+    }
+    benchmark::DoNotOptimize(left);
+  }
+
+  state.counters["uncertain"] =
+      double(uncertain) / std::max<size_t>(points.size() - 2, 1);
+  state.SetItemsProcessed(state.iterations() * (points.size() - 2));
+}
+
+/* Graham Scan on the same file with float, double and fixed-point int32
+ * coordinates, the latter being the three decimals of the file times 1000 */
+enum class Coordinates { Float, Double, Int32 };
+
+template <typename P>
+void run_coordinates(benchmark::State &state, const std::vector<P> &points) {
+  const GrahamScan<std::vector<P>> graham;
+  PerfRegion perf(state, points.size());
+  for (auto _ : state)
+    benchmark::DoNotOptimize(graham.compute(points));
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+void bench_coordinates(benchmark::State &state, Coordinates coordinates,
+                       Shape shape) {
+  const std::vector<Point> points = read_points(shape, state.range());
+  switch (coordinates) {
+  case Coordinates::Float:
+    run_coordinates(state, points);
+    break;
+  case Coordinates::Double: {
+    DoublePoints doubles;
+    for (const auto &p : points) {
+      doubles.emplace_back(p.x, p.y);
+    }
+    run_coordinates(state, doubles);
+    break;
+  }
+  case Coordinates::Int32:
+    run_coordinates(state, util::to_grid(points));
+    break;
+  }
+}
+
+/* Marriage Before Conquest (or V2) with every randomness and split policy.
+ * The seed changes at every iteration: the same shuffle of the same input
+ * over and over lets the branch predictor learn the whole run, which makes
+ * a fixed seed look twice as fast on small inputs. */
+void bench_mbc_policy(benchmark::State &state, MarriageNS::MBCRandom random,
+                      MarriageNS::MBCSplit split, bool v2, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+
+  PerfRegion perf(state, points.size());
+  uint64_t seed = 0;
+  for (auto _ : state) {
+    const MarriageNS::MBCPolicy policy{random, split, seed++};
+    if (v2) {
+      benchmark::DoNotOptimize(
+          MarriageNS::MarriageBeforeConquestV2(policy).compute(points));
+    } else {
+      benchmark::DoNotOptimize(
+          MarriageNS::MarriageBeforeConquest(policy).compute(points));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/* Sort stage of Graham Scan alone */
+void bench_sort(benchmark::State &state, GrahamSort sort, Shape shape) {
+  std::vector<Point> points = read_points(shape, state.range());
+
+  PerfRegion perf(state, points.size());
+  for (auto _ : state) {
+    std::vector<Point> sorted = points;
+    if (sort == GrahamSort::Radix) {
+      util::radix_sort(sorted);
+    } else {
+      std::sort(sorted.begin(), sorted.end(), point_cmp);
+    }
+    benchmark::DoNotOptimize(sorted.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/* Same kernel on the structure of arrays layout */
+void bench_farthest_soa(benchmark::State &state, simd::Level level,
+                        Shape shape) {
+  PointsSoA points(read_points(shape, state.range()));
+  Line l = util::findExtremePoints(points);
+  simd::set_level(level);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(simd::farthest(points.xs(), points.ys(),
+                                            points.size(), l.p1, l.p2));
+
+  state.SetLabel(simd::level_name(simd::level()));
+  state.SetItemsProcessed(state.iterations() * points.size());
+  simd::set_level(simd::detected_level());
+}
+
+const std::vector<int64_t> bench_sizes = benchmark::CreateRange(256, 524288, 2);
+const std::vector<int64_t> bench_threads_counts = {1, 2, 4, 8};
+
 BENCHMARK_CAPTURE(bench, grahamvec_circle, GrahamScan<std::vector<Point>>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, grahamvec_square, GrahamScan<std::vector<Point>>(), Square)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, grahamvec_parabola, GrahamScan<std::vector<Point>>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
@@ -51,14 +625,198 @@ BENCHMARK_CAPTURE(bench, grahamlist_parabola, GrahamScan<std::list<Point>>(), Pa
 BENCHMARK_CAPTURE(bench, grahamdeque_circle, GrahamScan<std::deque<Point>>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, grahamdeque_square, GrahamScan<std::deque<Point>>(), Square)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, grahamdeque_parabola, GrahamScan<std::deque<Point>>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, grahamradix_circle, GrahamScan<std::vector<Point>>(GrahamSort::Radix), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, grahamradix_square, GrahamScan<std::vector<Point>>(GrahamSort::Radix), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, grahamradix_parabola, GrahamScan<std::vector<Point>>(GrahamSort::Radix), Parabola)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, quick_circle, QuickHullNS::QuickHull(), Circle)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, quick_square, QuickHullNS::QuickHull(), Square)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, quick_parabola, QuickHullNS::QuickHull(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, quickinplace_circle, QuickHullNS::InPlaceQuickHull(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, quickinplace_square, QuickHullNS::InPlaceQuickHull(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, quickinplace_parabola, QuickHullNS::InPlaceQuickHull(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, quicksoa_circle, SoAInput<QuickHullNS::QuickHull>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, quicksoa_square, SoAInput<QuickHullNS::QuickHull>(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, quicksoa_parabola, SoAInput<QuickHullNS::QuickHull>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, marriage_circle, MarriageNS::MarriageBeforeConquest(), Circle)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, marriage_square, MarriageNS::MarriageBeforeConquest(), Square)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, marriage_parabola, MarriageNS::MarriageBeforeConquest(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, marriagesoa_circle, SoAInput<MarriageNS::MarriageBeforeConquest>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, marriagesoa_square, SoAInput<MarriageNS::MarriageBeforeConquest>(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, marriagesoa_parabola, SoAInput<MarriageNS::MarriageBeforeConquest>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, marriagev2_circle, MarriageNS::MarriageBeforeConquestV2(), Circle)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, marriagev2_square, MarriageNS::MarriageBeforeConquestV2(), Square)->RangeMultiplier(2)->Range(256, 524288);
 BENCHMARK_CAPTURE(bench, marriagev2_parabola, MarriageNS::MarriageBeforeConquestV2(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, chan_circle, ChanNS::Chan(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, chan_square, ChanNS::Chan(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, chan_parabola, ChanNS::Chan(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklgraham_circle, akl<GrahamScan<Points>>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklgraham_square, akl<GrahamScan<Points>>(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklgraham_parabola, akl<GrahamScan<Points>>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklgraham4_square, akl<GrahamScan<Points>>(4), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklquick_circle, akl<QuickHullNS::QuickHull>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklquick_square, akl<QuickHullNS::QuickHull>(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklquick_parabola, akl<QuickHullNS::QuickHull>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklmarriage_circle, akl<MarriageNS::MarriageBeforeConquest>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklmarriage_square, akl<MarriageNS::MarriageBeforeConquest>(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench, aklmarriage_parabola, akl<MarriageNS::MarriageBeforeConquest>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_extremes, scalar_square, simd::Level::Scalar, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_extremes, sse4_square, simd::Level::SSE4, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_extremes, avx2_square, simd::Level::AVX2, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_farthest, scalar_square, simd::Level::Scalar, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_farthest, sse4_square, simd::Level::SSE4, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_farthest, avx2_square, simd::Level::AVX2, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_predicates, rounded_square, Predicate::Rounded, false)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_predicates, filtered_square, Predicate::Filtered, false)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_predicates, exact_square, Predicate::Exact, false)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_predicates, rounded_collinear, Predicate::Rounded, true)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_predicates, filtered_collinear, Predicate::Filtered, true)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_predicates, exact_collinear, Predicate::Exact, true)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamfloat_circle, Coordinates::Float, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamfloat_square, Coordinates::Float, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamfloat_parabola, Coordinates::Float, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamdouble_circle, Coordinates::Double, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamdouble_square, Coordinates::Double, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamdouble_parabola, Coordinates::Double, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamint32_circle, Coordinates::Int32, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamint32_square, Coordinates::Int32, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_coordinates, grahamint32_parabola, Coordinates::Int32, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, seeded_shuffle_square, MarriageNS::MBCRandom::Seeded, MarriageNS::MBCSplit::Shuffle, false, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, threadlocal_shuffle_square, MarriageNS::MBCRandom::ThreadLocal, MarriageNS::MBCSplit::Shuffle, false, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_shuffle_square, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::Shuffle, false, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_shuffle_circle, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::Shuffle, false, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_shuffle_parabola, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::Shuffle, false, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_sampled_circle, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::SampledMedian, false, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_sampled_square, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::SampledMedian, false, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_sampled_parabola, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::SampledMedian, false, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_noshuffle_circle, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::NoShuffle, false, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_noshuffle_square, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::NoShuffle, false, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, counter_noshuffle_parabola, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::NoShuffle, false, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, v2counter_shuffle_square, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::Shuffle, true, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mbc_policy, v2counter_noshuffle_square, MarriageNS::MBCRandom::Counter, MarriageNS::MBCSplit::NoShuffle, true, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_sort, comparison_square, GrahamSort::Comparison, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_sort, radix_square, GrahamSort::Radix, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, grahamvec_circle, GrahamScan<std::vector<Point>>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, grahamvec_square, GrahamScan<std::vector<Point>>(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, grahamvec_parabola, GrahamScan<std::vector<Point>>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, quick_circle, QuickHullNS::QuickHull(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, quick_square, QuickHullNS::QuickHull(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, quick_parabola, QuickHullNS::QuickHull(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, quickinplace_circle, QuickHullNS::InPlaceQuickHull(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, quickinplace_square, QuickHullNS::InPlaceQuickHull(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, quickinplace_parabola, QuickHullNS::InPlaceQuickHull(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, marriage_circle, MarriageNS::MarriageBeforeConquest(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, marriage_square, MarriageNS::MarriageBeforeConquest(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, marriage_parabola, MarriageNS::MarriageBeforeConquest(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, marriagev2_circle, MarriageNS::MarriageBeforeConquestV2(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, marriagev2_square, MarriageNS::MarriageBeforeConquestV2(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, marriagev2_parabola, MarriageNS::MarriageBeforeConquestV2(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, chan_circle, ChanNS::Chan(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, chan_square, ChanNS::Chan(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, chan_parabola, ChanNS::Chan(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, aklquick_circle, akl<QuickHullNS::QuickHull>(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, aklquick_square, akl<QuickHullNS::QuickHull>(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_into, aklquick_parabola, akl<QuickHullNS::QuickHull>(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_load, text_circle, false, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_load, text_square, false, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_load, text_parabola, false, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_load, binary_circle, true, Circle)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_load, binary_square, true, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_load, binary_parabola, true, Parabola)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mapped, quick_circle, QuickHullNS::QuickHull(), Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mapped, quick_square, QuickHullNS::QuickHull(), Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_mapped, quick_parabola, QuickHullNS::QuickHull(), Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_farthest_soa, scalar_square, simd::Level::Scalar, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_farthest_soa, sse4_square, simd::Level::SSE4, Square)->RangeMultiplier(8)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_farthest_soa, avx2_square, simd::Level::AVX2, Square)->RangeMultiplier(8)->Range(256, 524288);
+
+BENCHMARK_CAPTURE(bench_parse, stream_circle, true, Circle)->Args({524288, 1})->UseRealTime();
+BENCHMARK_CAPTURE(bench_parse, fromchars_circle, false, Circle)->ArgsProduct({{524288}, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_parse, stream_square, true, Square)->Args({524288, 1})->UseRealTime();
+BENCHMARK_CAPTURE(bench_parse, fromchars_square, false, Square)->ArgsProduct({{524288}, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_parse, stream_parabola, true, Parabola)->Args({524288, 1})->UseRealTime();
+BENCHMARK_CAPTURE(bench_parse, fromchars_parabola, false, Parabola)->ArgsProduct({{524288}, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_incremental, circle, Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_incremental, square, Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_incremental, parabola, Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_dynamic, circle, Circle)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_dynamic, square, Square)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_dynamic, parabola, Parabola)->RangeMultiplier(2)->Range(256, 524288);
+BENCHMARK_CAPTURE(bench_small_sets, static_grahamvec, GrahamScan<Points>());
+BENCHMARK_CAPTURE(bench_small_sets, virtual_grahamvec, virtual_hull<GrahamScan<Points>>());
+BENCHMARK_CAPTURE(bench_small_sets, static_quick, QuickHullNS::QuickHull());
+BENCHMARK_CAPTURE(bench_small_sets, virtual_quick, virtual_hull<QuickHullNS::QuickHull>());
+BENCHMARK_CAPTURE(bench_small_sets, static_marriage, MarriageNS::MarriageBeforeConquest());
+BENCHMARK_CAPTURE(bench_small_sets, virtual_marriage, virtual_hull<MarriageNS::MarriageBeforeConquest>());
+BENCHMARK(bench_batch)->ArgsProduct({bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_window, sliding_circle, false, Circle)->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_CAPTURE(bench_window, recompute_circle, true, Circle)->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_CAPTURE(bench_window, sliding_square, false, Square)->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_CAPTURE(bench_window, recompute_square, true, Square)->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_CAPTURE(bench_window, sliding_parabola, false, Parabola)->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_CAPTURE(bench_window, recompute_parabola, true, Parabola)->RangeMultiplier(4)->Range(256, 65536);
+BENCHMARK_CAPTURE(bench_threads, grahamvecpar_circle, make_parallel<GrahamScan<Points>>, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, grahamvecpar_square, make_parallel<GrahamScan<Points>>, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, grahamvecpar_parabola, make_parallel<GrahamScan<Points>>, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, quickpar_circle, make_parallel<QuickHullNS::ParallelQuickHull>, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, quickpar_square, make_parallel<QuickHullNS::ParallelQuickHull>, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, quickpar_parabola, make_parallel<QuickHullNS::ParallelQuickHull>, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, marriagepar_circle, make_parallel<MarriageNS::ParallelMarriageBeforeConquest>, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, marriagepar_square, make_parallel<MarriageNS::ParallelMarriageBeforeConquest>, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_threads, marriagepar_parabola, make_parallel<MarriageNS::ParallelMarriageBeforeConquest>, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedgraham_circle, virtual_hull<GrahamScan<Points>>, ShardMerge::Tangents, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedgraham_square, virtual_hull<GrahamScan<Points>>, ShardMerge::Tangents, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedgraham_parabola, virtual_hull<GrahamScan<Points>>, ShardMerge::Tangents, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, uniongraham_circle, virtual_hull<GrahamScan<Points>>, ShardMerge::Union, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, uniongraham_square, virtual_hull<GrahamScan<Points>>, ShardMerge::Union, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, uniongraham_parabola, virtual_hull<GrahamScan<Points>>, ShardMerge::Union, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedquick_circle, virtual_hull<QuickHullNS::QuickHull>, ShardMerge::Tangents, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedquick_square, virtual_hull<QuickHullNS::QuickHull>, ShardMerge::Tangents, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedquick_parabola, virtual_hull<QuickHullNS::QuickHull>, ShardMerge::Tangents, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, unionquick_circle, virtual_hull<QuickHullNS::QuickHull>, ShardMerge::Union, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, unionquick_square, virtual_hull<QuickHullNS::QuickHull>, ShardMerge::Union, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, unionquick_parabola, virtual_hull<QuickHullNS::QuickHull>, ShardMerge::Union, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedmarriage_circle, virtual_hull<MarriageNS::MarriageBeforeConquest>, ShardMerge::Tangents, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedmarriage_square, virtual_hull<MarriageNS::MarriageBeforeConquest>, ShardMerge::Tangents, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, shardedmarriage_parabola, virtual_hull<MarriageNS::MarriageBeforeConquest>, ShardMerge::Tangents, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, unionmarriage_circle, virtual_hull<MarriageNS::MarriageBeforeConquest>, ShardMerge::Union, Circle)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, unionmarriage_square, virtual_hull<MarriageNS::MarriageBeforeConquest>, ShardMerge::Union, Square)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+BENCHMARK_CAPTURE(bench_sharded, unionmarriage_parabola, virtual_hull<MarriageNS::MarriageBeforeConquest>, ShardMerge::Union, Parabola)->ArgsProduct({bench_sizes, bench_threads_counts})->UseRealTime();
+
+BENCHMARK_CAPTURE(bench_generated, grahamradix_disk, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Disk)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_square, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Square)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_parabola, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Parabola)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_annulus, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Annulus)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_gaussian, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Gaussian)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_clustered, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Clustered)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_oncircle, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::OnCircle)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_duplicates, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Duplicates)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, grahamradix_collinear, GrahamScan<Points>(GrahamSort::Radix), gen::Distribution::Collinear)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_disk, QuickHullNS::QuickHull(), gen::Distribution::Disk)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_square, QuickHullNS::QuickHull(), gen::Distribution::Square)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_parabola, QuickHullNS::QuickHull(), gen::Distribution::Parabola)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_annulus, QuickHullNS::QuickHull(), gen::Distribution::Annulus)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_gaussian, QuickHullNS::QuickHull(), gen::Distribution::Gaussian)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_clustered, QuickHullNS::QuickHull(), gen::Distribution::Clustered)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_oncircle, QuickHullNS::QuickHull(), gen::Distribution::OnCircle)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_duplicates, QuickHullNS::QuickHull(), gen::Distribution::Duplicates)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, quick_collinear, QuickHullNS::QuickHull(), gen::Distribution::Collinear)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_disk, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Disk)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_square, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Square)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_parabola, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Parabola)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_annulus, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Annulus)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_gaussian, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Gaussian)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_clustered, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Clustered)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_oncircle, MarriageNS::MarriageBeforeConquest(), gen::Distribution::OnCircle)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_duplicates, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Duplicates)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, marriage_collinear, MarriageNS::MarriageBeforeConquest(), gen::Distribution::Collinear)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_disk, ChanNS::Chan(), gen::Distribution::Disk)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_square, ChanNS::Chan(), gen::Distribution::Square)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_parabola, ChanNS::Chan(), gen::Distribution::Parabola)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_annulus, ChanNS::Chan(), gen::Distribution::Annulus)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_gaussian, ChanNS::Chan(), gen::Distribution::Gaussian)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_clustered, ChanNS::Chan(), gen::Distribution::Clustered)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_oncircle, ChanNS::Chan(), gen::Distribution::OnCircle)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_duplicates, ChanNS::Chan(), gen::Distribution::Duplicates)->RangeMultiplier(8)->Range(256, 1 << 26);
+BENCHMARK_CAPTURE(bench_generated, chan_collinear, ChanNS::Chan(), gen::Distribution::Collinear)->RangeMultiplier(8)->Range(256, 1 << 26);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,172 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <stats.hpp>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* Hardware counters of the benchmarks, read with perf_event_open
+ *
+ * Every event is opened on its own, for the calling thread only and in user
+ * space (allowed with the default perf_event_paranoid = 2). An event that
+ * cannot be opened, e.g. in a VM without a PMU, without permission or on
+ * another OS, is left out of the output; without any of them the benchmarks
+ * simply have no hardware counters. The events are opened once and reused by
+ * every benchmark.
+ *
+ * Threads of the pool started before the counters are not counted: for the
+ * parallel benchmarks the counters are those of the calling thread.
+ */
+class PerfCounters {
+public:
+  static constexpr size_t events = 5;
+
+  static PerfCounters &instance() {
+    static PerfCounters counters;
+    return counters;
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  void start() {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        enable(fd, true);
+      }
+    }
+  }
+
+  /* Stop the events and add them to the counters of the state, divided by
+   * the points of an iteration */
+  void stop(benchmark::State &state, size_t points) {
+    for (size_t i = 0; i < events; i++) {
+      if (fds[i] < 0) {
+        continue;
+      }
+      enable(fds[i], false);
+      double value;
+      if (!read_scaled(fds[i], value)) {
+        continue;
+      }
+      state.counters[names[i]] = benchmark::Counter(
+          value / (points ? points : 1), benchmark::Counter::kAvgIterations);
+    }
+  }
+
+private:
+#ifdef __linux__
+  PerfCounters() {
+    const uint64_t l1Miss = PERF_COUNT_HW_CACHE_L1D |
+                            PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                            PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+    const uint32_t types[events] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                    PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE,
+                                    PERF_TYPE_HARDWARE};
+    const uint64_t configs[events] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, l1Miss,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (size_t i = 0; i < events; i++) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = types[i];
+      attr.config = configs[i];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      fds[i] = static_cast<int>(
+          syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+  }
+
+  ~PerfCounters() {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  /* Enable from zero, or disable */
+  static void enable(int fd, bool on) {
+    if (on) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    }
+    ioctl(fd, on ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+  }
+
+  /* The value is scaled up if the event was multiplexed with others, and
+   * there is none if it never ran */
+  static bool read_scaled(int fd, double &value) {
+    uint64_t format[3]; // value, time enabled, time running
+    if (read(fd, format, sizeof(format)) != ssize_t(sizeof(format)) ||
+        format[2] == 0) {
+      return false;
+    }
+    value = double(format[0]) * format[1] / format[2];
+    return true;
+  }
+#else
+  PerfCounters() = default;
+  static void enable(int, bool) {}
+  static bool read_scaled(int, double &) { return false; }
+#endif
+
+  static constexpr const char *names[events] = {
+      "cycles", "instructions", "l1_misses", "llc_misses", "branch_misses"};
+  int fds[events] = {-1, -1, -1, -1, -1};
+};
+
+/* Counters of a measured region: from its construction, just before the
+ * benchmark loop, to the end of the scope, after it. Use one per benchmark
+ * run, with the number of input points of an iteration.
+ *
+ * Besides the hardware counters, the region reports the algorithm statistics
+ * (see stats.hpp) when the library records them, i.e. in bench_stats and not
+ * in bench or bench_opt: orientation tests, exact fallbacks and discarded points per
+ * input point, recursions and bridge rounds per iteration, and the deepest
+ * recursion level. */
+class PerfRegion {
+public:
+  PerfRegion(benchmark::State &state, size_t points)
+      : state(state), points(points) {
+    stats::reset();
+    PerfCounters::instance().start();
+  }
+  ~PerfRegion() {
+    PerfCounters::instance().stop(state, points);
+    if constexpr (stats::enabled) {
+      const stats::Counters counters = stats::snapshot();
+      const double n = points ? points : 1;
+      auto average = [](double value) {
+        return benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+      };
+      state.counters["orientations"] = average(counters.orientations / n);
+      state.counters["exact"] = average(counters.exact / n);
+      state.counters["discarded"] = average(counters.discarded / n);
+      state.counters["recursions"] = average(counters.recursions);
+      state.counters["bridge_rounds"] = average(counters.bridge_rounds);
+      state.counters["max_depth"] = counters.max_depth;
+    }
+  }
+
+  PerfRegion(const PerfRegion &) = delete;
+  PerfRegion &operator=(const PerfRegion &) = delete;
+
+private:
+  benchmark::State &state;
+  size_t points;
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,41 @@
+#ifndef AKL_TOUSSAINT_HPP
+#define AKL_TOUSSAINT_HPP
+
+#include <common.hpp>
+#include <memory>
+
+/* Akl-Toussaint Heuristic
+ *
+ * Pre-filter that can be put in front of any convex hull algorithm: it finds
+ * the extreme points of the input in 4 (left, bottom, right, top) or 8 (also
+ * the diagonals) directions, and drops every point strictly inside the polygon
+ * they span, since such a point can never be a hull vertex. The hull of the
+ * remaining points is then computed by the wrapped algorithm, which is picked
+ * at run time (e.g. a VirtualHull).
+ */
+template <typename T>
+class AklToussaint : public HullAlgorithm<AklToussaint<T>, T> {
+private:
+  std::shared_ptr<const ConvexHull<T>> inner;
+  int directions;
+
+  /* filter, with the extreme polygon built in `polygon` */
+  void filter_into(const Points &points, Points &remaining,
+                   Points &polygon) const;
+
+public:
+  /* `directions` must be either 4 or 8 */
+  explicit AklToussaint(std::shared_ptr<const ConvexHull<T>> inner,
+                        int directions = 8);
+
+  /* The points that survive the filter, in input order */
+  Points filter(const Points &points) const;
+
+  using HullAlgorithm<AklToussaint<T>, T>::compute;
+  T compute(const std::vector<Point> &points) const;
+  /* The inner algorithm runs on the nested workspace 0 */
+  void compute_into(const std::vector<Point> &points, T &out,
+                    Workspace &workspace) const;
+};
+
+#endif // AKL_TOUSSAINT_HPP
@@ -0,0 +1,49 @@
+#ifndef BATCH_HULL_HPP
+#define BATCH_HULL_HPP
+
+#include <common.hpp>
+#include <vector>
+
+/* Many point sets in CSR layout: set i is points[offsets[i], offsets[i + 1]) */
+struct PointSets {
+  Points points;
+  std::vector<size_t> offsets{0};
+
+  size_t size() const { return offsets.size() - 1; }
+  bool empty() const { return size() == 0; }
+  PointsView operator[](size_t i) const {
+    return PointsView(points.data() + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  void add(const PointsView &set);
+  void clear();
+};
+
+/* Hulls of a batch of small point sets
+ *
+ * Every hull is the one GrahamScan<Points> gives for the set (clockwise from
+ * the leftmost, topmost point, with the same results for sets of at most two
+ * points and for identical points), written to a CSR output.
+ *
+ * Sets are handed out to the shared pool in chunks of about `grain` points.
+ * There is no virtual call and no allocation per set: sets of up to
+ * small_set points are sorted by insertion on the stack, larger ones in a
+ * buffer per chunk, and each hull is built in place in the output, which is
+ * sized once for the whole batch and compacted at the end.
+ */
+class BatchHull {
+public:
+  static constexpr size_t small_set = 64;
+
+  explicit BatchHull(unsigned threads = 1, size_t grain = 1 << 14)
+      : threads(threads), grain(grain) {}
+
+  /* hulls is overwritten; its buffers are reused across calls */
+  void compute(const PointSets &sets, PointSets &hulls) const;
+
+private:
+  unsigned threads;
+  size_t grain;
+};
+
+#endif // BATCH_HULL_HPP
@@ -0,0 +1,30 @@
+#ifndef CHAN_HPP
+#define CHAN_HPP
+
+#include <common.hpp>
+
+/* Chan's Algorithm Implementation
+ *
+ * Output sensitive O(n log h): the points are split into groups of m points,
+ * every group hull is computed with Graham Scan and the global hull is then
+ * wrapped (Jarvis march) for at most m steps, finding the tangent to each
+ * group hull with a binary search. If the hull is not closed within m steps
+ * the guess is squared and the procedure restarts.
+ */
+namespace ChanNS {
+class Chan : public HullAlgorithm<Chan, Points> {
+private:
+  /* The workspace holds the current group (buffer 0) and the group hulls
+   * (buffers 1..), the nested workspace 0 is used by Graham Scan */
+  bool wrap(const Points &points, size_t m, Points &hull,
+            Workspace &workspace) const;
+
+public:
+  using HullAlgorithm<Chan, Points>::compute;
+  Points compute(const Points &points) const;
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
+};
+} // namespace ChanNS
+
+#endif // CHAN_HPP
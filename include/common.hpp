@@ -1,32 +1,52 @@
 #ifndef COMMON_HPP
 #define COMMON_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <list>
+#include <memory>
 #include <vector>
 #include <ostream>
+#include <string>
+#include <utility>
 
-class Point {
+/* A point of the plane with coordinates of type T
+ *
+ * float is the coordinate type of the library (Point). Fixed-point grid
+ * coordinates in int32_t and double coordinates have exact orientation
+ * predicates too (see predicates.hpp) and run through GrahamScan.
+ */
+template <typename T>
+class BasicPoint {
 public:
-    float x;
-    float y;
-    Point();
-    Point(float x, float y);
-    bool operator==(const Point&) const;
-    bool operator!=(const Point&) const;
+    using coordinate_type = T;
+    T x;
+    T y;
+    // inline: the structure of arrays code builds a Point for every element
+    BasicPoint() : x(0), y(0) {}
+    BasicPoint(T x, T y) : x(x), y(y) {}
+    bool operator==(const BasicPoint& other) const { return x == other.x && y == other.y; }
+    bool operator!=(const BasicPoint& other) const { return !(*this == other); }
     std::string to_string() const;
 };
+
+using Point = BasicPoint<float>;
+using GridPoint = BasicPoint<int32_t>;
+using DoublePoint = BasicPoint<double>;
 void showValue(const Point &person, std::ostream &os);
 
-class Line {
+template <typename T>
+class BasicLine {
 public:
-    Point p1;
-    Point p2;
-    Line();
-    Line(float m, float q);
-    Line(const Point& p1, const Point& p2);
+    BasicPoint<T> p1;
+    BasicPoint<T> p2;
+    BasicLine() : p1(), p2() {}
+    BasicLine(const BasicPoint<T>& p1, const BasicPoint<T>& p2) : p1(p1), p2(p2) {}
 };
 
+using Line = BasicLine<float>;
+
 class Triangle {
 public:
     Point p1;
@@ -36,18 +56,228 @@ public:
 };
 
 
-/* linked list */
+/* Structure of arrays point container
+ *
+ * The x and y coordinates live in two separate 64-byte aligned arrays, so that
+ * a kernel can load consecutive coordinates straight into a vector register
+ * instead of de-interleaving Points. Both arrays share a single allocation:
+ * the y coordinates start right after the capacity of the x ones.
+ */
+class PointsSoA {
+public:
+    PointsSoA() = default;
+    explicit PointsSoA(const std::vector<Point>& points);
+    PointsSoA(const PointsSoA& other);
+    PointsSoA(PointsSoA&& other) noexcept;
+    PointsSoA& operator=(PointsSoA other) noexcept;
+    ~PointsSoA();
 
-/* Convex Hull Interface */
-template <typename T>
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    void reserve(std::size_t capacity);
+    void clear() { n = 0; }
+    void push_back(const Point& p) {
+        if (n == cap) {
+            reserve(cap == 0 ? 16 : 2 * cap);
+        }
+        data[n] = p.x;
+        data[cap + n] = p.y;
+        ++n;
+    }
+    Point operator[](std::size_t i) const { return Point(data[i], data[cap + i]); }
+
+    /* Read-only iteration, yields the points by value */
+    class const_iterator {
+    public:
+        const_iterator(const PointsSoA* points, std::size_t i) : points(points), i(i) {}
+        Point operator*() const { return (*points)[i]; }
+        const_iterator& operator++() { ++i; return *this; }
+        bool operator==(const const_iterator& other) const { return i == other.i; }
+        bool operator!=(const const_iterator& other) const { return i != other.i; }
+    private:
+        const PointsSoA* points;
+        std::size_t i;
+    };
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    const float* xs() const { return data; }
+    const float* ys() const { return data + cap; }
+
+    /* Back to the array of structures layout */
+    std::vector<Point> to_aos() const;
+
+private:
+    void* raw = nullptr; // allocation, data is its first 64-byte aligned float
+    float* data = nullptr;
+    std::size_t n = 0;
+    std::size_t cap = 0;
+};
+
+/* Read-only view of contiguous points owned by someone else, e.g. a memory
+ * mapped point file (see util::MappedPoints). Nothing is copied: the owner
+ * must outlive the view. */
+class PointsView {
+public:
+    PointsView() = default;
+    PointsView(const Point* points, std::size_t n) : first(points), n(n) {}
+    explicit PointsView(const std::vector<Point>& points) : first(points.data()), n(points.size()) {}
+
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    const Point* data() const { return first; }
+    const Point& operator[](std::size_t i) const { return first[i]; }
+    const Point* begin() const { return first; }
+    const Point* end() const { return first + n; }
+
+    /* Owning copy */
+    std::vector<Point> to_aos() const { return std::vector<Point>(begin(), end()); }
+
+private:
+    const Point* first = nullptr;
+    std::size_t n = 0;
+};
+
+/* Caller-owned scratch storage for ConvexHull::compute_into
+ *
+ * Algorithms borrow buffers by index, e.g. two per recursion depth, and
+ * nested workspaces for the algorithms they run internally. A buffer is
+ * never shrunk, so once a workspace has seen an input, later inputs of up to
+ * the same size (and shape) are computed without allocating.
+ *
+ * The content of a borrowed buffer is whatever the previous user left there.
+ * A workspace must not be shared by concurrent calls.
+ */
+class Workspace {
+public:
+    std::vector<Point>& points(std::size_t i);
+    PointsSoA& soa(std::size_t i);
+    std::vector<double>& values(std::size_t i);
+    Workspace& nested(std::size_t i);
+
+private:
+    // deques: growing them does not move the buffers already borrowed
+    std::deque<std::vector<Point>> pointBuffers;
+    std::deque<PointsSoA> soaBuffers;
+    std::deque<std::vector<double>> valueBuffers;
+    std::vector<std::unique_ptr<Workspace>> workspaces;
+};
+
+/* Convex Hull Interface
+ *
+ * T is the container of the hull and P the type of its points. The generic
+ * interface only takes a vector of them; float Points, the type of every
+ * algorithm, also come as structures of arrays and borrowed views (see the
+ * specialization below).
+ */
+template <typename T, typename P = typename T::value_type>
 class ConvexHull {
 public:
+    virtual ~ConvexHull() = default;
+    /* Every algorithm must implement the lower and upper hull and merge them */
+    virtual T compute(const std::vector<P>& points) const = 0;
+    /* Same hull as compute, written into `out`; see ConvexHull<T, Point> */
+    virtual void compute_into(const std::vector<P>& points, T& out, Workspace& workspace) const {
+        (void)workspace;
+        out = compute(points);
+    }
+};
+
+template <typename T>
+class ConvexHull<T, Point> {
+public:
+    virtual ~ConvexHull() = default;
     /* Every algorithm must implement the lower and upper hull and merge them */
     virtual T compute(const std::vector<Point>& points) const = 0;
+    /* Structure of arrays input: by default it is converted back to Points,
+     * algorithms with a native SoA path override it */
+    virtual T compute(const PointsSoA& points) const { return compute(points.to_aos()); }
+    /* Borrowed points: copied by default, algorithms that only read their
+     * input override it to skip the copy */
+    virtual T compute(const PointsView& points) const { return compute(points.to_aos()); }
+    /* Same hull as compute, written into `out` with the scratch storage
+     * borrowed from `workspace`. Algorithms that override it do not allocate
+     * once `out` and `workspace` are warm; the default just calls compute. */
+    virtual void compute_into(const std::vector<Point>& points, T& out, Workspace& workspace) const {
+        (void)workspace;
+        out = compute(points);
+    }
+};
+
+/* Compile-time algorithm interface (CRTP)
+ *
+ * Every algorithm derives from HullAlgorithm<Derived, T> and implements
+ * `T compute(const std::vector<P>&) const`; the base gives it the other entry
+ * points of ConvexHull, with the same defaults, but no virtual call. A caller
+ * that knows the type of the algorithm calls it directly, and so do the
+ * algorithms calling their own compute_into or an inner algorithm. Derived
+ * classes declare `using HullAlgorithm<...>::compute;` to keep the inherited
+ * overloads next to their own.
+ *
+ * ConvexHull remains the interface of the callers that pick the algorithm at
+ * run time, through VirtualHull.
+ */
+template <typename Derived, typename T, typename P = typename T::value_type>
+class HullAlgorithm {
+public:
+    using hull_type = T;
+    using point_type = P;
+
+    /* Structure of arrays and borrowed float points: converted to a vector
+     * by default */
+    T compute(const PointsSoA& points) const { return derived().compute(points.to_aos()); }
+    T compute(const PointsView& points) const { return derived().compute(points.to_aos()); }
+    /* Same hull as compute, written into `out`; by default just compute */
+    void compute_into(const std::vector<P>& points, T& out, Workspace& workspace) const {
+        (void)workspace;
+        out = derived().compute(points);
+    }
+
+protected:
+    ~HullAlgorithm() = default;
+
+private:
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+/* Runtime adapter: a HullAlgorithm behind the ConvexHull interface, e.g.
+ * std::make_shared<VirtualHull<QuickHullNS::QuickHull>>() */
+template <typename Algorithm, typename P = typename Algorithm::point_type>
+class VirtualHull final : public ConvexHull<typename Algorithm::hull_type> {
+    using T = typename Algorithm::hull_type;
+    Algorithm algorithm;
+
+public:
+    template <typename... Args>
+    explicit VirtualHull(Args&&... args) : algorithm(std::forward<Args>(args)...) {}
+
+    T compute(const std::vector<P>& points) const override { return algorithm.compute(points); }
+    void compute_into(const std::vector<P>& points, T& out, Workspace& workspace) const override {
+        algorithm.compute_into(points, out, workspace);
+    }
+};
+
+template <typename Algorithm>
+class VirtualHull<Algorithm, Point> final : public ConvexHull<typename Algorithm::hull_type> {
+    using T = typename Algorithm::hull_type;
+    Algorithm algorithm;
+
+public:
+    template <typename... Args>
+    explicit VirtualHull(Args&&... args) : algorithm(std::forward<Args>(args)...) {}
+
+    T compute(const std::vector<Point>& points) const override { return algorithm.compute(points); }
+    T compute(const PointsSoA& points) const override { return algorithm.compute(points); }
+    T compute(const PointsView& points) const override { return algorithm.compute(points); }
+    void compute_into(const std::vector<Point>& points, T& out, Workspace& workspace) const override {
+        algorithm.compute_into(points, out, workspace);
+    }
 };
 
 using Points = std::vector<Point>;
 using PointsList = std::list<Point>;
 using PointsDeque = std::deque<Point>;
+using GridPoints = std::vector<GridPoint>;
+using DoublePoints = std::vector<DoublePoint>;
 
 #endif // COMMON_HPP
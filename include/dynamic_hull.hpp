@@ -0,0 +1,133 @@
+#ifndef DYNAMIC_HULL_HPP
+#define DYNAMIC_HULL_HPP
+
+#include <common.hpp>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/* Fully dynamic convex hull (Overmars-van Leeuwen)
+ *
+ * The points are the leaves of an AVL tree in lexicographic (x, y) order.
+ * Every internal node stores the bridge of its children: the edge of the
+ * upper hull of its subtree that joins the upper hulls of its two children.
+ * The upper hull of a node is the hull of its left child up to the bridge,
+ * followed by the hull of its right child from the bridge on, so no hull is
+ * stored explicitly: a bridge is found in O(log n) descending both children
+ * at once, and an update recomputes the bridges on its path in O(log^2 n).
+ *
+ * The lower hull is a second tree on the points mirrored across the x axis.
+ * Duplicate points are counted. As in Graham Scan, points on a hull edge are
+ * not vertices.
+ */
+class DynamicHull {
+public:
+  /* O(log^2 n) */
+  void insert(const Point &p);
+  /* Remove one copy of p, O(log^2 n). Returns false if p is not in the set. */
+  bool erase(const Point &p);
+  void clear();
+
+  /* Number of points in the set, duplicates included */
+  size_t count() const { return points; }
+  bool empty() const { return points == 0; }
+
+  /* Number of vertices of the hull, O(1) */
+  size_t size() const;
+
+  /* The vertices, clockwise from the leftmost (topmost) one: the same hull as
+   * GrahamScan<Points> on the points (if there are at least three, and they
+   * are not all the same point). O(h log n) */
+  Points hull() const;
+
+  /* Whether p is inside or on the boundary of the hull, O(log^2 n) */
+  bool contains(const Point &p) const;
+
+  /* A vertex with the largest dot product with `direction`, O(log n).
+   * The set must not be empty. */
+  Point extreme(const Point &direction) const;
+
+  /* For p outside the hull: the points of contact of the two tangents from p,
+   * that is the vertices before and after p (clockwise) on the hull of the
+   * points and p. Nothing if p is inside or on the hull. O(log^2 n) */
+  std::optional<std::pair<Point, Point>> tangents(const Point &p) const;
+
+private:
+  /* Upper hull of a multiset of points */
+  class Chain {
+  public:
+    void insert(const Point &p);
+    bool erase(const Point &p);
+    void clear();
+
+    bool empty() const { return root < 0; }
+    /* Number of vertices, and lexicographically smallest and largest points;
+     * the chain must not be empty */
+    size_t size() const { return nodes[root].hullSize; }
+    const Point &min() const { return nodes[root].min; }
+    const Point &max() const { return nodes[root].max; }
+
+    /* The vertices, left to right */
+    void vertices(Points &out) const;
+
+    /* Vertex with the largest dot product with `direction`, which must have
+     * a y >= 0 component (the chain is then unimodal along it) */
+    Point extreme(const Point &direction) const;
+
+    /* Where p would be on the upper hull of the points and p: whether it is a
+     * vertex, and its neighbours there, if any. p is not a vertex if it is
+     * one of the points. */
+    struct Neighbours {
+      bool vertex;
+      std::optional<Point> left;
+      std::optional<Point> right;
+    };
+    Neighbours neighbours(const Point &p) const;
+
+  private:
+    struct Node {
+      int left = -1; // both children are -1 for a leaf
+      int right = -1;
+      int height = 0;
+      uint32_t copies = 0; // leaves: multiplicity of the point
+      // leaves: a is the point; internal nodes: the bridge (a, b)
+      Point a, b;
+      // lexicographic extremes of the subtree
+      Point min, max;
+      // vertices of the hull of the subtree: those of the left child up to
+      // a, and those of the right child hull but the first rightSkip
+      size_t leftCount = 1;
+      size_t rightSkip = 0;
+      size_t hullSize = 1;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    int root = -1;
+    // whether the last update added or removed a leaf, or found the point
+    bool reshaped = false;
+    bool found = false;
+
+    bool isLeaf(int v) const { return nodes[v].left < 0; }
+    int allocate();
+    int insertAt(int v, const Point &p);
+    int eraseAt(int v, const Point &p);
+    int rebalance(int v);
+    int rotateLeft(int v);
+    int rotateRight(int v);
+    void update(int v);
+    void bridge(int v);
+    size_t countUpTo(int v, const Point &p) const;
+    void collect(int v, const Point *from, const Point *to, Points &out) const;
+    Point extremeAt(int v, const Point &direction) const;
+    Point tangentFromLeft(int v, const Point &p) const;
+    Point tangentFromRight(int v, const Point &p) const;
+  };
+
+  Chain upper;
+  Chain lower; // mirrored points
+  size_t points = 0;
+};
+
+#endif // DYNAMIC_HULL_HPP
@@ -0,0 +1,55 @@
+#ifndef GENERATE_HPP
+#define GENERATE_HPP
+
+#include <common.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/* Seeded point generators
+ *
+ * In process replacement of the files of vis/generate_tests.py for the
+ * benchmarks: nothing is written to disk, and the sizes go up to 2^26 and
+ * beyond. Point i only depends on the seed and on i (a SplitMix64 stream per
+ * point), so the points are generated in parallel chunks and are the same for
+ * any number of threads.
+ */
+namespace gen {
+
+enum class Distribution {
+  Disk,       // uniform in the disk of radius `radius`
+  Square,     // uniform in [-radius, radius]^2
+  Parabola,   // on a parabola, with distinct x while n < 2^25
+  Annulus,    // uniform between 0.9 radius and radius
+  Gaussian,   // normal, sigma = radius / 3
+  Clustered,  // normal around 16 centres, sigma = radius / 64
+  OnCircle,   // on the circle: h = n before the float rounding, ~n/3 at 10^5
+  Duplicates, // n / 64 distinct uniform points of the square, each repeated
+  Collinear,  // on the sides and the diagonals of the square
+};
+
+/* Every distribution, in declaration order */
+constexpr Distribution distributions[] = {
+    Distribution::Disk,      Distribution::Square,     Distribution::Parabola,
+    Distribution::Annulus,   Distribution::Gaussian,   Distribution::Clustered,
+    Distribution::OnCircle,  Distribution::Duplicates, Distribution::Collinear,
+};
+
+const char *distribution_name(Distribution distribution);
+
+/* Scale of every distribution */
+constexpr float radius = 1000;
+
+/* n points of the distribution, in no particular order
+ *
+ * Parameters:
+ *  - distribution: The distribution to draw from
+ *  - n: The number of points
+ *  - seed: The seed, the same seed always gives the same points
+ *  - threads: Generating threads, 0 for one per hardware thread
+ */
+Points generate(Distribution distribution, size_t n, uint64_t seed = 42,
+                unsigned threads = 0);
+
+} // namespace gen
+
+#endif // GENERATE_HPP
@@ -5,11 +5,50 @@
 #include <list>
 #include <vector>
 
-/* Gramham Scan Implementation */
+/* Sorting order of the scan: x ascending, y descending on ties */
+bool point_cmp(const Point &a, const Point &b);
+
+/* How the scan sorts the points, which dominates its cost at large n */
+enum class GrahamSort {
+  Comparison, // std::sort, or parallel_sort with threads > 1
+  Radix,      // util::radix_sort, serial
+};
+
+/* Gramham Scan Implementation
+ *
+ * With threads > 1 the comparison sort runs as a parallel merge sort on the
+ * shared pool (see parallel_sort); inputs with at most `cutoff` points are
+ * still sorted serially. Every sort gives the same hull.
+ *
+ * The points are those of the hull container: float Points, and also
+ * GridPoints and DoublePoints (see BasicPoint), which are always sorted by
+ * comparison.
+ */
 template <typename Points>
-class GrahamScan : public ConvexHull<Points> {
+class GrahamScan : public HullAlgorithm<GrahamScan<Points>, Points> {
+public:
+  using point_type = typename Points::value_type;
+
+private:
+  unsigned threads;
+  size_t cutoff;
+  GrahamSort sort;
+
+  void sortPoints(std::vector<point_type> &points) const;
+
 public:
-  Points compute(const std::vector<Point> &points) const override;
+  explicit GrahamScan(unsigned threads = 1, size_t cutoff = 1 << 14)
+      : threads(threads), cutoff(cutoff), sort(GrahamSort::Comparison) {}
+  explicit GrahamScan(GrahamSort sort)
+      : threads(1), cutoff(1 << 14), sort(sort) {}
+
+  using HullAlgorithm<GrahamScan<Points>, Points>::compute;
+  Points compute(const std::vector<point_type> &points) const;
+  /* No allocation with the serial comparison sort; the parallel and radix
+   * sorts still allocate their own buffers, a list output allocates its
+   * nodes, and points other than float ones have no workspace buffers */
+  void compute_into(const std::vector<point_type> &points, Points &out,
+                    Workspace &workspace) const;
 };
 
 std::list<Point> compute_list(const std::vector<Point> &points);
@@ -0,0 +1,51 @@
+#ifndef INCREMENTAL_HULL_HPP
+#define INCREMENTAL_HULL_HPP
+
+#include <common.hpp>
+#include <map>
+
+/* Online (insertion only) convex hull
+ *
+ * The upper and lower chains are kept in two balanced search trees keyed by
+ * x. Inserting a point looks up its neighbours in each chain, which tells
+ * whether it is inside the hull; otherwise the vertices it hides are erased
+ * walking outward from it. An insertion costs O(log h) amortized, since
+ * every vertex is erased at most once.
+ *
+ * As in Graham Scan, points on a hull edge are not vertices.
+ */
+class IncrementalHull {
+public:
+  IncrementalHull() = default;
+  explicit IncrementalHull(const Points &points);
+
+  /* Add a point. Returns false if it was inside (or on) the hull, which is
+   * then unchanged. */
+  bool insert(const Point &p);
+
+  /* Whether p is inside or on the boundary of the hull */
+  bool contains(const Point &p) const;
+
+  bool empty() const { return upper.empty(); }
+  void clear();
+
+  /* Number of vertices of the hull */
+  size_t size() const;
+
+  /* The vertices, clockwise from the leftmost (topmost) one: the same hull
+   * as GrahamScan<Points> on the inserted points (if there are at least
+   * three, and they are not all the same point) */
+  Points hull() const;
+
+private:
+  /* x -> y of the vertices of the upper chain, and x -> -y of the lower one:
+   * mirroring the lower chain makes it an upper chain too */
+  using Chain = std::map<float, float>;
+  Chain upper;
+  Chain lower;
+
+  static bool insert(Chain &chain, float x, float y);
+  static bool below(const Chain &chain, float x, float y);
+};
+
+#endif // INCREMENTAL_HULL_HPP
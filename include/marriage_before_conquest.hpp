@@ -1,28 +1,138 @@
 #include <common.hpp>
+#include <cstdint>
 
 /* QuickHull Implementation */
 
 namespace MarriageNS {
-class MarriageBeforeConquest : public ConvexHull<Points> {
+/* Where the randomness of Marriage Before Conquest comes from. It only
+ * changes the running time: every policy gives the same hull. */
+enum class MBCRandom {
+  Seeded,      // a std::mt19937_64 seeded with the policy seed on every call
+  ThreadLocal, // one std::mt19937_64 per thread, seeded once by random_device
+  Counter,     // SplitMix64 of the seed plus a counter: no engine to set up
+};
+
+/* How the points are split at every level of the recursion */
+enum class MBCSplit {
+  Shuffle,       // shuffled copy of the input, split at the exact median x
+  SampledMedian, // input order, median x of a random sample of the set
+  NoShuffle,     // input order, exact median x: for inputs known to be random
+};
+
+struct MBCPolicy {
+  MBCRandom random = MBCRandom::Counter;
+  MBCSplit split = MBCSplit::Shuffle;
+  uint64_t seed = 0;
+};
+
+class MarriageBeforeConquest
+    : public HullAlgorithm<MarriageBeforeConquest, Points> {
 protected:
-  void MBCUpperRecursive(const Points &points, Points &hull) const;
-  void MBCLowerRecursive(const Points &points, Points &hull) const;
-  Line findUpperBridge(const Points &points) const;
-  Line findLowerBridge(const Points &points) const;
+  MBCPolicy policy;
+
+  /* Split line of every bridge, as the policy says */
+  struct Splitter;
+
+  /* The recursion is written once for both Points and PointsSoA sets. The
+   * workspace holds the shuffled input (buffer 0, Shuffle split only), the
+   * bridge candidates (buffer 1) and the two subsets of every recursion
+   * depth. */
+  template <typename Set>
+  void computeHull(const Set &points, Points &hull, Workspace &workspace) const;
+  /* The input in the order of the split policy, a shuffled copy in buffer 0
+   * or the points themselves, and the splitter of the recursion */
+  template <typename Set>
+  Splitter prepare(const Set &points, const Set *&input,
+                   Workspace &workspace) const;
+  /* One level of the recursion: the leaves go to the hull, otherwise the
+   * bridge splits the points into leftSet and rightSet. Returns whether
+   * there is anything to recurse on. */
+  template <typename Set>
+  bool upperStep(const Set &points, Points &hull, Workspace &workspace,
+                 Splitter &splitter, Set &leftSet, Set &rightSet) const;
+  template <typename Set>
+  bool lowerStep(const Set &points, Points &hull, Workspace &workspace,
+                 Splitter &splitter, Set &leftSet, Set &rightSet) const;
+  template <typename Set>
+  void MBCUpperRecursive(const Set &points, Points &hull, Workspace &workspace,
+                         Splitter &splitter, size_t depth) const;
+  template <typename Set>
+  void MBCLowerRecursive(const Set &points, Points &hull, Workspace &workspace,
+                         Splitter &splitter, size_t depth) const;
+  template <typename Set>
+  Line findUpperBridge(const Set &points, Workspace &workspace,
+                       Splitter &splitter) const;
+  template <typename Set>
+  Line findLowerBridge(const Set &points, Workspace &workspace,
+                       Splitter &splitter) const;
 
 public:
-  Points compute(const Points &points) const override;
+  explicit MarriageBeforeConquest(MBCPolicy policy = MBCPolicy())
+      : policy(policy) {}
+
+  using HullAlgorithm<MarriageBeforeConquest, Points>::compute;
+  Points compute(const Points &points) const;
+  Points compute(const PointsSoA &points) const;
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
+};
+
+/* Parallel Marriage Before Conquest
+ *
+ * The upper and lower hulls, and the left and right subproblems of every
+ * recursion on more than `cutoff` points, run as tasks on the shared pool.
+ * Every task builds its own part of the hull and the parts are spliced in
+ * the order the serial recursion appends them, so the hull is identical to
+ * MarriageBeforeConquest::compute.
+ */
+class ParallelMarriageBeforeConquest : public MarriageBeforeConquest {
+private:
+  unsigned threads;
+  size_t cutoff;
+
+  void upperParallel(const Points &points, Points &hull,
+                     Splitter &splitter) const;
+  void lowerParallel(const Points &points, Points &hull,
+                     Splitter &splitter) const;
+
+public:
+  explicit ParallelMarriageBeforeConquest(unsigned threads,
+                                          size_t cutoff = 1 << 14,
+                                          MBCPolicy policy = MBCPolicy());
+  Points compute(const Points &points) const;
+  /* Converted to Points: the tasks share the array of structures recursion */
+  Points compute(const PointsSoA &points) const;
+  Points compute(const PointsView &points) const;
+  /* Not allocation free: every task allocates its sets and sub-hulls */
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
 };
 
-class MarriageBeforeConquestV2 : public ConvexHull<Points> {
+class MarriageBeforeConquestV2
+    : public HullAlgorithm<MarriageBeforeConquestV2, Points> {
 protected:
-  void MBCUpperRecursive(const Points &points, Points &hull) const;
-  void MBCLowerRecursive(const Points &points, Points &hull) const;
-  Line findUpperBridge(const Points &points, const Line &extremes) const;
-  Line findLowerBridge(const Points &points, const Line &extremes) const;
+  /* Only the shuffle of the policy applies: V2 splits at the middle of its
+   * extremes, so SampledMedian keeps the input order like NoShuffle */
+  MBCPolicy policy;
+
+  /* Same workspace layout as MarriageBeforeConquest */
+  void MBCUpperRecursive(const Points &points, Points &hull,
+                         Workspace &workspace, size_t depth) const;
+  void MBCLowerRecursive(const Points &points, Points &hull,
+                         Workspace &workspace, size_t depth) const;
+  Line findUpperBridge(const Points &points, const Line &extremes,
+                       Workspace &workspace) const;
+  Line findLowerBridge(const Points &points, const Line &extremes,
+                       Workspace &workspace) const;
 
 public:
-  Points compute(const Points &points) const override;
+  explicit MarriageBeforeConquestV2(MBCPolicy policy = MBCPolicy())
+      : policy(policy) {}
+
+  using HullAlgorithm<MarriageBeforeConquestV2, Points>::compute;
+  Points compute(const Points &points) const;
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
 };
 
 } // namespace MarriageNS
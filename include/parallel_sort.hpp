@@ -0,0 +1,93 @@
+#ifndef PARALLEL_SORT_HPP
+#define PARALLEL_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread_pool.hpp>
+#include <vector>
+
+/* Parallel merge sort on the shared work-stealing pool
+ *
+ * The vector is split into one run per thread (rounded up to a power of two),
+ * every run is sorted with std::sort as a task, then the runs are merged
+ * pairwise in log(runs) rounds, ping-ponging with a buffer. Each merge is
+ * itself split in independent pieces (co-ranked with a binary search) so that
+ * the last rounds, with few large merges, still keep every thread busy.
+ *
+ * Merges take from the left run first on ties, so elements that compare equal
+ * keep the same relative order that std::sort left within each run; for a
+ * strict weak order whose equal elements are identical (as point_cmp) the
+ * result is exactly the one of std::sort.
+ *
+ * Inputs with at most `cutoff` elements, or threads <= 1, use std::sort.
+ */
+template <typename T, typename Compare>
+void parallel_sort(std::vector<T> &values, Compare cmp, unsigned threads,
+                   size_t cutoff = 1 << 14) {
+  const size_t n = values.size();
+  if (threads <= 1 || n <= std::max<size_t>(cutoff, 2)) {
+    std::sort(values.begin(), values.end(), cmp);
+    return;
+  }
+
+  size_t runs = 1;
+  while (runs < threads && n / (2 * runs) > 0) {
+    runs *= 2;
+  }
+  auto bound = [n, runs](size_t i) { return n * i / runs; };
+
+  ThreadPool &pool = ThreadPool::shared(threads);
+
+  /* 1. Sort every run */
+  {
+    TaskGroup group(pool);
+    for (size_t r = 0; r < runs; ++r) {
+      group.run([&, r] {
+        std::sort(values.begin() + bound(r), values.begin() + bound(r + 1),
+                  cmp);
+      });
+    }
+    group.wait();
+  }
+
+  /* 2. Merge adjacent runs, doubling their width at every round */
+  std::vector<T> buffer(n);
+  T *from = values.data();
+  T *to = buffer.data();
+  for (size_t width = 1; width < runs; width *= 2) {
+    const size_t merges = runs / (2 * width);
+    const size_t parts = std::max<size_t>(1, threads / merges);
+
+    TaskGroup group(pool);
+    for (size_t m = 0; m < merges; ++m) {
+      const T *a = from + bound(2 * m * width);
+      const T *b = from + bound((2 * m + 1) * width);
+      const T *end = from + bound((2 * m + 2) * width);
+      T *out = to + bound(2 * m * width);
+      const size_t na = b - a;
+
+      for (size_t p = 0; p < parts; ++p) {
+        // a[aBegin, aEnd) is merged with the elements of b that sort between
+        // a[aBegin] and a[aEnd]
+        const size_t aBegin = na * p / parts;
+        const size_t aEnd = na * (p + 1) / parts;
+        const T *bBegin =
+            p == 0 ? b : std::lower_bound(b, end, a[aBegin], cmp);
+        const T *bEnd =
+            p + 1 == parts ? end : std::lower_bound(b, end, a[aEnd], cmp);
+        T *dest = out + aBegin + (bBegin - b);
+        group.run([=] {
+          std::merge(a + aBegin, a + aEnd, bBegin, bEnd, dest, cmp);
+        });
+      }
+    }
+    group.wait();
+    std::swap(from, to);
+  }
+
+  if (from != values.data()) {
+    std::copy(from, from + n, values.data());
+  }
+}
+
+#endif // PARALLEL_SORT_HPP
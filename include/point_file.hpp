@@ -0,0 +1,69 @@
+#ifndef POINT_FILE_HPP
+#define POINT_FILE_HPP
+
+#include <common.hpp>
+#include <cstdint>
+#include <string>
+
+/* Binary point files
+ *
+ * A 64-byte header followed by `count` packed (x, y) float pairs in native
+ * byte order, exactly the memory layout of Point. The file is mapped and the
+ * points are handed out in place, so loading costs a page fault per 4 KiB
+ * touched instead of a text parse per coordinate.
+ */
+namespace util {
+
+constexpr uint32_t point_file_version = 1;
+
+enum PointFileFlags : uint32_t {
+  // the points are sorted as point_cmp (x ascending, y descending)
+  PointFileSorted = 1u << 0,
+};
+
+struct PointFileHeader {
+  char magic[8]; // "HULLPTS" and a terminating zero
+  uint32_t version;
+  uint32_t flags;
+  uint64_t count;
+  // bounding box, all zeros for an empty file
+  float minX, minY, maxX, maxY;
+  uint8_t reserved[24];
+};
+static_assert(sizeof(PointFileHeader) == 64, "the points start at offset 64");
+static_assert(sizeof(Point) == 2 * sizeof(float), "Point must be packed");
+
+/* Write the points, computing the bounding box and the sorted flag */
+void write_point_file(const std::string &filename, const Points &points);
+
+/* Read-only mapping of a binary point file
+ *
+ * Throws std::runtime_error if the file cannot be mapped, is not a point
+ * file, has another version or its size does not match the header.
+ */
+class MappedPoints {
+public:
+  explicit MappedPoints(const std::string &filename);
+  MappedPoints(const MappedPoints &) = delete;
+  MappedPoints &operator=(const MappedPoints &) = delete;
+  MappedPoints(MappedPoints &&other) noexcept;
+  MappedPoints &operator=(MappedPoints &&other) noexcept;
+  ~MappedPoints();
+
+  const PointFileHeader &header() const;
+  bool sorted() const { return header().flags & PointFileSorted; }
+
+  /* The points in the mapping, valid as long as this object */
+  PointsView points() const;
+
+private:
+  void *mapping = nullptr;
+  size_t length = 0;
+};
+
+/* Whether the file starts with the binary point file magic */
+bool is_point_file(const std::string &filename);
+
+} // namespace util
+
+#endif // POINT_FILE_HPP
@@ -0,0 +1,79 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include <cmath>
+#include <common.hpp>
+#include <cstdint>
+#include <limits>
+#include <stats.hpp>
+#include <type_traits>
+
+/* Orientation predicates with an exact sign
+ *
+ * Floating-point coordinates: the cross product is first computed in double,
+ * and its sign is returned when it is larger than the worst case rounding
+ * error of that computation (the semi-static filter of Shewchuk's orient2d).
+ * Only the uncertain cases, collinear and nearly collinear points, go through
+ * the exact fallback, which sums the cross product exactly as an expansion of
+ * products of two coordinates. The value is the cross product itself on the
+ * fast path and an approximation of it with the right sign otherwise, so it
+ * can still be used as a (partial) distance.
+ *
+ * Fixed-point int32_t coordinates: the cross product is computed exactly in
+ * int64_t, without a branch.
+ */
+namespace util {
+
+/* Bound on the relative error of the double cross product (3ε + 16ε², with
+ * ε = 2^-53), see Shewchuk, "Adaptive Precision Floating-Point Arithmetic
+ * and Fast Robust Geometric Predicates" */
+constexpr double cross_error_bound =
+    (3.0 + 16.0 * (std::numeric_limits<double>::epsilon() / 2)) *
+    (std::numeric_limits<double>::epsilon() / 2);
+
+/* Cross product (b - a) x (d - c) within an ulp, with its exact sign. The
+ * product of two floats is exact in double; those of two doubles are split
+ * in two, so their coordinates must stay below 2^500 or so in magnitude */
+double exact_cross(const Point &a, const Point &b, const Point &c,
+                   const Point &d);
+double exact_cross(const DoublePoint &a, const DoublePoint &b,
+                   const DoublePoint &c, const DoublePoint &d);
+
+/* Cross product (b - a) x (d - c): > 0 when d - c turns left of b - a,
+ * < 0 when it turns right and = 0 when they are parallel, exactly */
+template <typename T>
+inline double cross(const BasicPoint<T> &a, const BasicPoint<T> &b,
+                    const BasicPoint<T> &c, const BasicPoint<T> &d) {
+  static_assert(std::is_floating_point_v<T>,
+                "integer coordinates other than int32_t have no cross product");
+  const double left = (double(b.x) - a.x) * (double(d.y) - c.y);
+  const double right = (double(b.y) - a.y) * (double(d.x) - c.x);
+  const double det = left - right;
+  if (std::abs(det) >= cross_error_bound * (std::abs(left) + std::abs(right))) {
+    stats::orientation(false);
+    return det;
+  }
+  stats::orientation(true);
+  return exact_cross(a, b, c, d);
+}
+
+/* Exact for coordinates of magnitude below 2^30: the differences then fit
+ * in 31 bits and their products in 62 */
+inline int64_t cross(const GridPoint &a, const GridPoint &b,
+                     const GridPoint &c, const GridPoint &d) {
+  stats::orientation(false);
+  return (int64_t(b.x) - a.x) * (int64_t(d.y) - c.y) -
+         (int64_t(b.y) - a.y) * (int64_t(d.x) - c.x);
+}
+
+/* Orientation of p3 with respect to the line through p1 and p2, in the sign
+ * convention of sidedness: > 0 when p3 is on the left of p1 -> p2 */
+template <typename T>
+inline auto orientation(const BasicPoint<T> &p1, const BasicPoint<T> &p2,
+                        const BasicPoint<T> &p3) {
+  return cross(p2, p3, p2, p1);
+}
+
+} // namespace util
+
+#endif // PREDICATES_HPP
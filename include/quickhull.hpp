@@ -2,11 +2,71 @@
 
 /* QuickHull Implementation */
 namespace QuickHullNS {
-class QuickHull : public ConvexHull<Points> {
-private:
+class QuickHull : public HullAlgorithm<QuickHull, Points> {
+protected:
   void findHullRecursive(const Point &p1, const Point &p2, const Points &points,
                          Points &hull) const;
+  /* The subsets of each depth are borrowed from the workspace */
+  void findHullRecursive(const Point &p1, const Point &p2, const Points &points,
+                         Points &hull, Workspace &workspace,
+                         size_t depth) const;
+  void findHullRecursive(const Point &p1, const Point &p2,
+                         const PointsSoA &points, Points &hull) const;
+  /* compute_into for Points or a PointsView: only the first pass reads the
+   * input, the recursion works on the copied subsets */
+  template <typename Input>
+  void computeFrom(const Input &points, Points &hull,
+                   Workspace &workspace) const;
+public:
+  Points compute(const Points &points) const;
+  /* Native structure of arrays path, returns the same hull */
+  Points compute(const PointsSoA &points) const;
+  /* Reads the borrowed points in place */
+  Points compute(const PointsView &points) const;
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
+};
+
+/* Parallel QuickHull
+ *
+ * The upper and lower hulls, and every left/right recursion on more than
+ * `cutoff` points, are run as tasks on a work-stealing pool. The sub-hulls are
+ * concatenated in the same order as the serial algorithm, so the result is
+ * identical to QuickHull::compute.
+ */
+class ParallelQuickHull : public QuickHull {
+private:
+  unsigned threads;
+  size_t cutoff;
+
+  void findHullParallel(const Point &p1, const Point &p2, const Points &points,
+                        Points &hull) const;
+public:
+  explicit ParallelQuickHull(unsigned threads, size_t cutoff = 1 << 14);
+  Points compute(const Points &points) const;
+  /* Converted to Points: the tasks share the array of structures recursion */
+  Points compute(const PointsSoA &points) const;
+  Points compute(const PointsView &points) const;
+  /* Not allocation free: every task and sub-hull allocates */
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
+};
+
+/* In-place QuickHull
+ *
+ * The input is copied once into a scratch buffer, then every recursion level
+ * partitions its own subrange in place. A single pass over a subrange both
+ * splits it into the points left of (p1, q) and left of (q, p2) and finds the
+ * farthest point of each half, so there is no per-level heap allocation.
+ */
+class InPlaceQuickHull : public HullAlgorithm<InPlaceQuickHull, Points> {
+private:
+  void findHullInPlace(const Point &p1, const Point &p2, const Point &q,
+                       Point *first, Point *last, Points &hull) const;
 public:
-  Points compute(const Points &points) const override;
+  using HullAlgorithm<InPlaceQuickHull, Points>::compute;
+  Points compute(const Points &points) const;
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
 };
 } // namespace QuickHullNS
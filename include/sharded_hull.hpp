@@ -0,0 +1,55 @@
+#ifndef SHARDED_HULL_HPP
+#define SHARDED_HULL_HPP
+
+#include <common.hpp>
+#include <memory>
+
+/* How ShardedHull splits the input and merges the local hulls */
+enum class ShardMerge {
+  Tangents, // x-separated shards, local hulls merged pairwise in a tree
+  Union,    // slices of the input, one last hull of the local hull vertices
+};
+
+/* Sharded Divide and Merge
+ *
+ * Parallel driver that can be put around any convex hull algorithm, picked at
+ * run time like the inner algorithm of AklToussaint: the input is split into
+ * one shard per thread, the hulls of the shards are computed concurrently on
+ * the shared pool by the inner algorithm, then merged.
+ *
+ * - Tangents: the shards are partitioned in point_cmp order (nth_element), so
+ *   every shard lies left of the next one. Each local hull is split into its
+ *   upper and lower chains, and neighbours are merged pairwise in a tree: the
+ *   chain of two x-separated hulls is the monotone chain of one after the
+ *   other, whose stack walks back to the tangent in linear time.
+ * - Union: the shards are slices of the input in its order, and the inner
+ *   algorithm runs once more over the vertices of all the local hulls.
+ *
+ * Inputs of at most `cutoff` points, or threads <= 1, go straight to the inner
+ * algorithm, which should itself be serial.
+ */
+class ShardedHull : public HullAlgorithm<ShardedHull, Points> {
+private:
+  std::shared_ptr<const ConvexHull<Points>> inner;
+  unsigned threads;
+  ShardMerge merge;
+  size_t cutoff;
+
+  Points tangents(const Points &points) const;
+  Points unite(const Points &points) const;
+
+public:
+  /* `threads` is 0 for one per hardware thread */
+  explicit ShardedHull(std::shared_ptr<const ConvexHull<Points>> inner,
+                       unsigned threads = 0,
+                       ShardMerge merge = ShardMerge::Tangents,
+                       size_t cutoff = 1 << 14);
+
+  using HullAlgorithm<ShardedHull, Points>::compute;
+  Points compute(const Points &points) const;
+  /* Not allocation free: the shards and their hulls have their own buffers */
+  void compute_into(const Points &points, Points &hull,
+                    Workspace &workspace) const;
+};
+
+#endif // SHARDED_HULL_HPP
@@ -0,0 +1,51 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <common.hpp>
+#include <cstddef>
+
+/* SIMD kernels for the linear passes shared by the algorithms
+ *
+ * Every kernel has an AVX2, an SSE4.1 and a scalar implementation: the best
+ * one supported by the CPU is selected at runtime, and all of them return
+ * exactly the same result as the scalar loops they replace.
+ */
+namespace simd {
+
+enum class Level { Scalar = 0, SSE4 = 1, AVX2 = 2 };
+
+/* Best level supported by the CPU */
+Level detected_level();
+
+/* Level currently used by the kernels (the detected one by default) */
+Level level();
+
+/* Force a level, e.g. to benchmark the scalar fallback. Levels that the CPU
+ * does not support are clamped to the detected one. */
+void set_level(Level level);
+
+const char *level_name(Level level);
+
+/* Leftmost and rightmost points; for each of them the lowest and the highest
+ * point with the same x-coordinate. Requires n > 0. */
+struct Extremes {
+  Point leftYMin;
+  Point leftYMax;
+  Point rightYMin;
+  Point rightYMax;
+};
+Extremes extremes(const Point *points, size_t n);
+
+/* Same as above, on structure of arrays coordinates (see PointsSoA) */
+Extremes extremes(const float *xs, const float *ys, size_t n);
+
+/* Index of the first point with the largest util::partial_distance from the
+ * line (p1, p2). Returns n if no distance is larger than -1. */
+size_t farthest(const Point *points, size_t n, const Point &p1,
+                const Point &p2);
+size_t farthest(const float *xs, const float *ys, size_t n, const Point &p1,
+                const Point &p2);
+
+} // namespace simd
+
+#endif // SIMD_HPP
@@ -0,0 +1,53 @@
+#ifndef SLIDING_WINDOW_HULL_HPP
+#define SLIDING_WINDOW_HULL_HPP
+
+#include <common.hpp>
+#include <deque>
+#include <dynamic_hull.hpp>
+
+/* Convex hull of a sliding window over a point stream
+ *
+ * The window is a queue: points are pushed at the back and popped from the
+ * front, either explicitly, by count (the last `capacity` points) or by time
+ * (the points newer than a given timestamp). The queue keeps the arrival
+ * order, and a DynamicHull the hull of its points, so that every push and pop
+ * costs O(log^2 W) whatever the window size W and the shape of the hull,
+ * with no recomputation between windows.
+ */
+class SlidingWindowHull {
+public:
+  /* capacity: points kept by push_back, 0 for no limit */
+  explicit SlidingWindowHull(size_t capacity = 0) : capacity(capacity) {}
+
+  /* Append a point, dropping the oldest one if the window is full */
+  void push_back(const Point &p, double time = 0);
+  /* Drop the oldest point; the window must not be empty */
+  void pop_front();
+  /* Drop the points older than `time`, returns how many */
+  size_t expire(double time);
+  void clear();
+
+  /* Number of points in the window */
+  size_t count() const { return window.size(); }
+  bool empty() const { return window.empty(); }
+  const Point &front() const { return window.front().point; }
+  const Point &back() const { return window.back().point; }
+
+  /* Number of vertices of the hull */
+  size_t size() const { return dynamic.size(); }
+  /* The vertices, clockwise from the leftmost (topmost) one, as DynamicHull */
+  Points hull() const { return dynamic.hull(); }
+  /* Hull queries on the window, see DynamicHull */
+  const DynamicHull &queries() const { return dynamic; }
+
+private:
+  struct Sample {
+    Point point;
+    double time;
+  };
+  std::deque<Sample> window;
+  DynamicHull dynamic;
+  size_t capacity;
+};
+
+#endif // SLIDING_WINDOW_HULL_HPP
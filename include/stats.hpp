@@ -0,0 +1,144 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef HULL_STATS
+#include <atomic>
+#endif
+
+/* Algorithm Statistics
+ *
+ * Counters of the work done by the algorithms, to check their behaviour by
+ * experiment (e.g. that Marriage Before Conquest is output sensitive):
+ * - orientation tests, every call of util::cross (isLeft, sidedness,
+ *   orientation), and how many needed the exact fallback
+ * - recursive calls of QuickHull and Marriage Before Conquest (V1 and V2),
+ *   with the deepest level reached
+ * - rounds of the Kirkpatrick-Seidel bridge search of Marriage Before Conquest
+ * - points discarded at each level of these recursions: those that go to
+ *   neither subproblem (up to twice per point for Marriage Before Conquest,
+ *   whose upper and lower hulls are separate recursions)
+ *
+ * They are only recorded when HULL_STATS is defined, as it is for the
+ * instrumented hullib_stats (bench_stats, convex_hull_stats) and not for
+ * hullib or hullib_opt; otherwise the hooks compile to nothing and
+ * snapshot() is all zeros. Every thread counts in its own block, which only
+ * it writes, so the hooks are plain loads and stores and the threads of the
+ * parallel algorithms do not share cache lines. snapshot() sums the blocks
+ * of every thread, those of the threads that have exited included: the work
+ * of all the algorithms running in the process is counted together.
+ *
+ * Usage: stats::reset(), run the algorithm, then read stats::snapshot(),
+ * both while no algorithm runs.
+ */
+namespace stats {
+
+#ifdef HULL_STATS
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+/* Levels with their own discarded counter, deeper ones share the last */
+constexpr size_t levels = 64;
+
+struct Counters {
+  uint64_t orientations = 0;
+  uint64_t exact = 0;
+  uint64_t recursions = 0;
+  uint64_t max_depth = 0;
+  uint64_t bridge_rounds = 0;
+  uint64_t discarded = 0;
+  std::array<uint64_t, levels> discarded_at{};
+};
+
+void reset();
+Counters snapshot();
+
+#ifdef HULL_STATS
+namespace detail {
+enum Counter { Orientations, Exact, Recursions, BridgeRounds, Discarded, Count };
+
+/* The counters of one thread. They are atomics only so that snapshot() may
+ * read them from another thread: their thread is the only writer. */
+struct alignas(64) Block {
+  std::atomic<uint64_t> counters[Count] = {};
+  std::atomic<uint64_t> max_depth = 0;
+  std::atomic<uint64_t> discarded_at[levels] = {};
+};
+
+/* Registers the block of the calling thread, and folds it into the totals of
+ * the exited threads when the thread exits */
+struct Slot {
+  Slot();
+  ~Slot();
+  Slot(const Slot &) = delete;
+  Slot &operator=(const Slot &) = delete;
+  Block *block;
+};
+
+inline Block &local() {
+  thread_local Slot slot;
+  return *slot.block;
+}
+
+inline void bump(std::atomic<uint64_t> &counter, uint64_t n) {
+  counter.store(counter.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+
+inline void add(Counter counter, uint64_t n = 1) {
+  bump(local().counters[counter], n);
+}
+} // namespace detail
+#endif
+
+/* The hooks of the algorithms */
+
+inline void orientation(bool exact) {
+#ifdef HULL_STATS
+  detail::Block &block = detail::local();
+  detail::bump(block.counters[detail::Orientations], 1);
+  if (exact) {
+    detail::bump(block.counters[detail::Exact], 1);
+  }
+#else
+  (void)exact;
+#endif
+}
+
+inline void recursion(size_t depth) {
+#ifdef HULL_STATS
+  detail::Block &block = detail::local();
+  detail::bump(block.counters[detail::Recursions], 1);
+  if (depth > block.max_depth.load(std::memory_order_relaxed)) {
+    block.max_depth.store(depth, std::memory_order_relaxed);
+  }
+#else
+  (void)depth;
+#endif
+}
+
+inline void bridge_round() {
+#ifdef HULL_STATS
+  detail::add(detail::BridgeRounds);
+#endif
+}
+
+inline void discarded(size_t depth, size_t points) {
+#ifdef HULL_STATS
+  detail::Block &block = detail::local();
+  detail::bump(block.counters[detail::Discarded], points);
+  detail::bump(block.discarded_at[depth < levels ? depth : levels - 1], points);
+#else
+  (void)depth;
+  (void)points;
+#endif
+}
+
+} // namespace stats
+
+#endif // STATS_HPP
@@ -0,0 +1,91 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Work-stealing Thread Pool
+ *
+ * Every worker owns a deque of tasks: it pushes and pops at the back (LIFO,
+ * good locality for recursive algorithms) while idle workers steal from the
+ * front of the other deques (FIFO, they take the biggest pending subproblem).
+ *
+ * A thread that waits on a TaskGroup keeps executing pending tasks instead of
+ * blocking, so tasks can spawn and wait on sub-tasks without deadlocking.
+ */
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  /* Create a pool with `workers` background threads (0 is allowed: tasks are
+   * then executed by the threads that wait on them) */
+  explicit ThreadPool(unsigned workers);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /* Enqueue a task. If called from a worker of this pool the task goes into
+   * the worker's own deque, otherwise it is distributed round-robin. */
+  void submit(Task task);
+
+  /* Execute one pending task, if any. Returns false if no task was found. */
+  bool try_run_one();
+
+  unsigned workers() const { return static_cast<unsigned>(threads.size()); }
+
+  /* Process-wide pool that, together with the calling thread, runs `threads`
+   * tasks concurrently. Pools are created lazily and live until exit. */
+  static ThreadPool &shared(unsigned threads);
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool pop_local(size_t index, Task &task);
+  bool steal(size_t start, Task &task);
+  void worker_loop(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> threads;
+  std::atomic<size_t> queued{0};
+  std::atomic<size_t> next_queue{0};
+
+  std::mutex sleep_mutex;
+  std::condition_variable sleep_cv;
+  bool stop = false;
+};
+
+/* Set of tasks that can be waited on together.
+ *
+ * The first exception thrown by a task is rethrown by wait().
+ */
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool &pool);
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  void run(ThreadPool::Task task);
+  void wait();
+
+private:
+  ThreadPool &pool;
+  std::atomic<size_t> pending{0};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+};
+
+#endif // THREAD_POOL_HPP
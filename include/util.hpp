@@ -2,8 +2,10 @@
 #define UTIL_HPP
 
 #include <common.hpp>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <predicates.hpp>
 #include <string>
 
 namespace util {
@@ -20,12 +22,30 @@ namespace util {
  *  - > 0 if point is above the line
  *  - < 0 if point is below the line
  *  - = 0 if point is on the line
+ *
+ * The sign is exact (see orientation in predicates.hpp), and these are inline
+ * since every algorithm calls them once or more per point.
  */
-double sidedness(const Line &l, const Point &p);
-double sidedness(const Point &p1, const Point &p2, const Point &p3);
+template <typename T>
+inline auto sidedness(const BasicPoint<T> &p1, const BasicPoint<T> &p2,
+                      const BasicPoint<T> &p3) {
+  return orientation(p1, p2, p3);
+}
+template <typename T>
+inline auto sidedness(const BasicLine<T> &l, const BasicPoint<T> &p) {
+  return sidedness(l.p1, l.p2, p);
+}
 
-bool isLeft(const Point &p1, const Point &p2, const Point &p3);
-bool isLeft(const Line &l, const Point &p);
+/* p3 is strictly on the left of p1 -> p2 (above it if p1.x < p2.x) */
+template <typename T>
+inline bool isLeft(const BasicPoint<T> &p1, const BasicPoint<T> &p2,
+                   const BasicPoint<T> &p3) {
+  return orientation(p1, p2, p3) > 0;
+}
+template <typename T>
+inline bool isLeft(const BasicLine<T> &l, const BasicPoint<T> &p) {
+  return isLeft(l.p1, l.p2, p);
+}
 
 /* Determine if point p is inside triangle t
  *
@@ -59,13 +79,39 @@ void print_points(const T &points) {
 
 template <typename T> bool is_valid_hull(const T &hull, const Points &points);
 
+/* Parse points in the text format of read_points_from_file
+ *
+ * The text is split into chunks at line boundaries, the points of every chunk
+ * are counted, then the chunks are parsed in parallel with std::from_chars
+ * straight into their slot of `points`, which is resized to the header n.
+ *
+ * Throws std::runtime_error("<name>:<line>: <reason>") on a malformed line,
+ * or if the number of points does not match the header.
+ *
+ * Parameters:
+ *  - first, last: The text to parse
+ *  - points: Replaced by the parsed points
+ *  - threads: Parsing threads, 0 for one per hardware thread
+ *  - name: The name of the text in error messages
+ */
+void parse_points(const char *first, const char *last, Points &points,
+                  unsigned threads = 0, const std::string &name = "<text>");
+
+/* Read a whole text point file in large blocks and parse it (see
+ * parse_points) into `points` */
+void parse_points_file(const std::string &filename, Points &points,
+                       unsigned threads = 0);
+
 /* Read points from a file
  *
  * The file should contain points in the following format:
+ * n
  * x1 y1
  * x2 y2
  * ...
  *
+ * with one point per line. The points are appended to the container.
+ *
  * Parameters:
  *  - filename: The name of the file to read from
  *  - container: The container to store the points in (e.g., Points)
@@ -74,17 +120,30 @@ template <typename Container>
 void read_points_from_file(const std::string &filename, Container &container) {
   static_assert(std::is_same_v<typename Container::value_type, Point>,
                 "Container must hold Point objects");
-  std::ifstream file(filename);
-
-  if (!file.is_open()) {
-    throw std::runtime_error("Cannot open file: " + filename);
+  Points points;
+  parse_points_file(filename, points);
+  if constexpr (std::is_same_v<Container, Points>) {
+    if (container.empty()) {
+      container.swap(points);
+      return;
+    }
   }
+  container.insert(container.end(), points.begin(), points.end());
+}
+
+/* Stream version of read_points_from_file, one `>>` per coordinate. Slower,
+ * it is kept as the reference the parser is checked and benchmarked against.
+ */
+template <typename Container>
+void read_points_from_stream(std::istream &stream, Container &container) {
+  static_assert(std::is_same_v<typename Container::value_type, Point>,
+                "Container must hold Point objects");
   int n;
-  file >> n;
+  stream >> n;
 
   float x, y;
   for (int i = 0; i < n; ++i) {
-    file >> x >> y;
+    stream >> x >> y;
     container.emplace_back(x, y);
   }
 }
@@ -100,8 +159,29 @@ using TPoint = std::pair<Point, Point>;
  * rightmost_ymax)>
  */
 std::pair<TPoint, TPoint> findExtremePointsCases(const Points &points);
+std::pair<TPoint, TPoint> findExtremePointsCases(const PointsSoA &points);
+std::pair<TPoint, TPoint> findExtremePointsCases(const PointsView &points);
 
 Line findExtremePoints(const Points &points, bool upper = true);
+Line findExtremePoints(const PointsSoA &points, bool upper = true);
+Line findExtremePoints(const PointsView &points, bool upper = true);
+
+/* Order preserving key of a point: comparing two keys as unsigned integers
+ * gives the same result as point_cmp (x ascending, y descending). -0.0 and
+ * 0.0 get the same key, as they compare equal as floats. */
+uint64_t sort_key(const Point &p);
+
+/* Sort the points in point_cmp order with an LSD radix sort on sort_key.
+ *
+ * The sort is stable, O(n) and allocates a buffer of n (key, point) pairs;
+ * digits that are the same for every key are skipped. Small inputs fall back
+ * to std::stable_sort on the same keys. */
+void radix_sort(Points &points);
+
+/* Fixed-point copy of the points: every coordinate times `scale`, rounded to
+ * the nearest integer. The point files have three decimals, so the default
+ * scale keeps them exactly. */
+GridPoints to_grid(const Points &points, float scale = 1000);
 
 /* Print the results of the three algorithms into files
  *
@@ -0,0 +1,108 @@
+#include <akl_toussaint.hpp>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <util.hpp>
+
+namespace {
+/* Extreme points of the input in counter-clockwise order, starting from the
+ * leftmost one. Consecutive duplicates are removed. */
+void extremePolygon(const Points &points, int directions, Points &polygon) {
+  constexpr float inf = std::numeric_limits<float>::infinity();
+
+  /* One branch-free pass keeps, for every direction, the largest key and the
+   * first point attaining it. The directions are in counter-clockwise order:
+   * left, bottom-left, bottom, bottom-right, right, top-right, top, top-left,
+   * each as a key to maximize. */
+  float best[8] = {-inf, -inf, -inf, -inf, -inf, -inf, -inf, -inf};
+  Point found[8];
+  std::fill(found, found + 8, points[0]);
+  for (const auto &p : points) {
+    const float sum = p.x + p.y;
+    const float diff = p.x - p.y;
+    const float keys[8] = {-p.x, -sum, -p.y, diff, p.x, sum, p.y, -diff};
+    for (int d = 0; d < 8; d++) {
+      const bool better = keys[d] > best[d];
+      best[d] = better ? keys[d] : best[d];
+      found[d] = better ? p : found[d];
+    }
+  }
+
+  const int step = directions == 8 ? 1 : 2;
+  polygon.clear();
+  for (int d = 0; d < 8; d += step) {
+    if (polygon.empty() || polygon.back() != found[d]) {
+      polygon.push_back(found[d]);
+    }
+  }
+  if (polygon.size() > 1 && polygon.front() == polygon.back()) {
+    polygon.pop_back();
+  }
+}
+} // namespace
+
+template <typename T>
+AklToussaint<T>::AklToussaint(std::shared_ptr<const ConvexHull<T>> inner,
+                              int directions)
+    : inner(std::move(inner)), directions(directions) {
+  if (directions != 4 && directions != 8) {
+    throw std::invalid_argument("Akl-Toussaint supports 4 or 8 directions");
+  }
+}
+
+template <typename T>
+Points AklToussaint<T>::filter(const Points &points) const {
+  Points remaining, polygon;
+  filter_into(points, remaining, polygon);
+  return remaining;
+}
+
+template <typename T>
+void AklToussaint<T>::filter_into(const Points &points, Points &remaining,
+                                  Points &polygon) const {
+  remaining.clear();
+  if (points.size() <= 3) {
+    remaining.assign(points.begin(), points.end());
+    return;
+  }
+
+  extremePolygon(points, directions, polygon);
+  if (polygon.size() < 3) {
+    // degenerate polygon, nothing is strictly inside it
+    remaining.assign(points.begin(), points.end());
+    return;
+  }
+
+  /* The polygon is counter-clockwise: a point is strictly inside it if it is
+   * strictly on the left of every edge */
+  const size_t k = polygon.size();
+  for (const auto &p : points) {
+    bool inside = true;
+    for (size_t i = 0; i < k; ++i) {
+      if (!util::isLeft(polygon[i], polygon[(i + 1) % k], p)) {
+        inside = false;
+        break;
+      }
+    }
+    if (!inside) {
+      remaining.push_back(p);
+    }
+  }
+}
+
+template <typename T>
+T AklToussaint<T>::compute(const std::vector<Point> &points) const {
+  return inner->compute(filter(points));
+}
+
+template <typename T>
+void AklToussaint<T>::compute_into(const std::vector<Point> &points, T &out,
+                                   Workspace &workspace) const {
+  Points &remaining = workspace.points(0);
+  filter_into(points, remaining, workspace.points(1));
+  inner->compute_into(remaining, out, workspace.nested(0));
+}
+
+template class AklToussaint<Points>;
+template class AklToussaint<PointsList>;
+template class AklToussaint<PointsDeque>;
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <batch_hull.hpp>
+#include <predicates.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+/* point_cmp and the turn test of Graham Scan (b is popped unless a, b, c
+ * turn to `side`), inlined: with a handful of points per set the calls into
+ * other translation units cost more than the comparisons */
+inline bool before(const Point &a, const Point &b) {
+  return a.x != b.x ? a.x < b.x : a.y > b.y;
+}
+
+inline bool turns(double side, const Point &a, const Point &b, const Point &c) {
+  return util::orientation(a, c, b) * side <= 0;
+}
+
+/* One half of the hull of the sorted points, into half; returns its size */
+size_t chain(const Point *points, size_t n, double side, Point *half) {
+  size_t h = 0;
+  half[h++] = points[0];
+  half[h++] = points[1];
+  for (size_t i = 2; i < n; i++) {
+    while (h >= 2 && turns(side, half[h - 2], half[h - 1], points[i])) {
+      --h;
+    }
+    half[h++] = points[i];
+  }
+  return h;
+}
+
+/* Hull of at least three sorted points into out, which has room for n:
+ * the upper chain, then the lower one backwards without its end points */
+size_t sorted_hull(const Point *points, size_t n, Point *out, Point *lower) {
+  size_t h = chain(points, n, 1.0, out);
+  const size_t l = chain(points, n, -1.0, lower);
+  for (size_t i = l - 1; i-- > 1;) {
+    out[h++] = lower[i];
+  }
+  return h;
+}
+
+size_t set_hull(const PointsView &set, Point *out, Points &scratch) {
+  const size_t n = set.size();
+  if (n <= 2) {
+    std::copy(set.begin(), set.end(), out);
+    return n;
+  }
+
+  if (n <= BatchHull::small_set) {
+    Point sorted[BatchHull::small_set];
+    Point lower[BatchHull::small_set];
+    // insertion sort: fewer moves than std::sort at this size
+    for (size_t i = 0; i < n; i++) {
+      const Point p = set[i];
+      size_t j = i;
+      for (; j > 0 && before(p, sorted[j - 1]); j--) {
+        sorted[j] = sorted[j - 1];
+      }
+      sorted[j] = p;
+    }
+    return sorted_hull(sorted, n, out, lower);
+  }
+
+  scratch.resize(2 * n);
+  std::copy(set.begin(), set.end(), scratch.begin());
+  std::sort(scratch.begin(), scratch.begin() + n, before);
+  return sorted_hull(scratch.data(), n, out, scratch.data() + n);
+}
+} // namespace
+
+void PointSets::add(const PointsView &set) {
+  points.insert(points.end(), set.begin(), set.end());
+  offsets.push_back(points.size());
+}
+
+void PointSets::clear() {
+  points.clear();
+  offsets.assign(1, 0);
+}
+
+void BatchHull::compute(const PointSets &sets, PointSets &hulls) const {
+  const size_t count = sets.size();
+  // a hull has at most as many points as its set: the output is sized once
+  hulls.points.resize(sets.points.size());
+  hulls.offsets.resize(count + 1);
+  hulls.offsets[0] = 0;
+
+  /* 1. Every hull is built where its set starts in the output, and its size
+   * is kept in the next offset for now */
+  Point *out = hulls.points.data();
+  size_t *sizes = hulls.offsets.data() + 1;
+  const auto run = [&sets, out, sizes](size_t first, size_t last) {
+    Points scratch;
+    for (size_t i = first; i < last; i++) {
+      sizes[i] = set_hull(sets[i], out + sets.offsets[i], scratch);
+    }
+  };
+
+  if (threads <= 1 || sets.points.size() <= grain) {
+    run(0, count);
+  } else {
+    TaskGroup group(ThreadPool::shared(threads));
+    for (size_t first = 0; first < count;) {
+      size_t last = first + 1;
+      while (last < count && sets.offsets[last] - sets.offsets[first] < grain) {
+        ++last;
+      }
+      group.run([&run, first, last] { run(first, last); });
+      first = last;
+    }
+    group.wait();
+  }
+
+  /* 2. Compact: every hull moves down to the end of the previous one. The
+   * destination is never past the source; when it is the source itself the
+   * hull is already in place, and std::copy does not allow that overlap. */
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    const size_t size = sizes[i];
+    const Point *from = out + sets.offsets[i];
+    if (out + total != from) {
+      std::copy(from, from + size, out + total);
+    }
+    total += size;
+    sizes[i] = total;
+  }
+  hulls.points.resize(total);
+}
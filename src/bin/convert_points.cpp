@@ -0,0 +1,34 @@
+#include <iostream>
+#include <point_file.hpp>
+#include <stdexcept>
+#include <string>
+#include <util.hpp>
+
+/* Convert text point files (see util::read_points_from_file) to the binary
+ * point format (see point_file.hpp). Every `<file>` is written to
+ * `<file>.bin`, next to it. */
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <points file>..." << std::endl;
+    return 1;
+  }
+
+  int failures = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string input = argv[i];
+    const std::string output = input + ".bin";
+    try {
+      Points points;
+      util::read_points_from_file(input, points);
+      util::write_point_file(output, points);
+
+      util::MappedPoints mapped(output);
+      std::cout << output << ": " << mapped.header().count << " points"
+                << (mapped.sorted() ? ", sorted" : "") << std::endl;
+    } catch (const std::runtime_error &e) {
+      std::cerr << e.what() << std::endl;
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
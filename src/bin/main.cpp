@@ -1,19 +1,39 @@
 #include "common.hpp"
+#include <akl_toussaint.hpp>
+#include <algorithm>
+#include <batch_hull.hpp>
 #include <cassert>
+#include <cmath>
+#include <chan.hpp>
+#include <dynamic_hull.hpp>
+#include <filesystem>
+#include <fstream>
+#include <generate.hpp>
 #include <graham_scan.hpp>
+#include <incremental_hull.hpp>
 #include <iostream>
 #include <marriage_before_conquest.hpp>
 #include <ostream>
+#include <parallel_sort.hpp>
+#include <point_file.hpp>
+#include <predicates.hpp>
 #include <quickhull.hpp>
 #include <random>
+#include <sharded_hull.hpp>
+#include <simd.hpp>
+#include <sliding_window_hull.hpp>
+#include <stats.hpp>
+#include <thread>
 #include <util.hpp>
 #include <vector>
 
-template <typename T>
-T testAlgorithm(ConvexHull<T> *algorithm, const Points &points,
-                const std::string &name) {
+template <typename Algorithm>
+typename Algorithm::hull_type testAlgorithm(const Algorithm &algorithm,
+                                            const Points &points,
+                                            const std::string &name) {
+  using T = typename Algorithm::hull_type;
   std::cout << "------ Testing " << name << " algorithm..." << std::endl;
-  T hull = algorithm->compute(points);
+  T hull = algorithm.compute(points);
   bool is_correct = util::is_valid_hull<T>(hull, points);
   if (is_correct) {
     std::cout << "Test Pass: Hull is valid" << std::endl;
@@ -95,6 +115,104 @@ int main() {
   // std::cout << "MBC Hull Points:" << std::endl;
   // util::print_points(mbc_hull2);
 
+  // every randomness and split policy of Marriage Before Conquest
+  std::vector<MarriageNS::MBCPolicy> mbcPolicies;
+  for (auto random : {MarriageNS::MBCRandom::Seeded,
+                      MarriageNS::MBCRandom::ThreadLocal,
+                      MarriageNS::MBCRandom::Counter}) {
+    for (auto split : {MarriageNS::MBCSplit::Shuffle,
+                       MarriageNS::MBCSplit::SampledMedian,
+                       MarriageNS::MBCSplit::NoShuffle}) {
+      mbcPolicies.push_back({random, split, mbcPolicies.size()});
+    }
+  }
+
+  /* Generated inputs: the same for any number of threads, over more than one
+   * chunk, and every algorithm agrees on their hull */
+  for (auto distribution : gen::distributions) {
+    const size_t n = 100000;
+    const Points generated = gen::generate(distribution, n, 7, 1);
+    assert(generated.size() == n);
+    assert(generated == gen::generate(distribution, n, 7, 4));
+    assert(generated != gen::generate(distribution, n, 8, 1));
+
+    Points distinct = generated;
+    std::sort(distinct.begin(), distinct.end(), point_cmp);
+    distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                   distinct.end());
+    if (distribution == gen::Distribution::Duplicates) {
+      assert(distinct.size() <= n / 64);
+    }
+    if (distribution == gen::Distribution::Parabola) {
+      assert(distinct.size() == n);
+      assert(!std::is_sorted(generated.begin(), generated.end(), point_cmp));
+    }
+    if (distribution == gen::Distribution::Collinear) {
+      for ([[maybe_unused]] const auto &p : generated) {
+        assert(std::abs(p.x) == gen::radius || std::abs(p.y) == gen::radius ||
+               std::abs(p.x) == std::abs(p.y));
+      }
+    }
+
+    const Points generatedHull = GrahamScan<Points>().compute(generated);
+    assert(MarriageNS::MarriageBeforeConquest().compute(generated) ==
+           generatedHull);
+    assert(ChanNS::Chan().compute(generated) == generatedHull);
+    assert(QuickHullNS::QuickHull().compute(generated).size() ==
+           generatedHull.size());
+  }
+
+  /* Algorithm statistics, only recorded in the hullib_stats build: the work
+   * of Marriage Before Conquest follows the hull size h, not n */
+  if constexpr (stats::enabled) {
+    auto measure = [](const auto &algorithm, const Points &points) {
+      stats::reset();
+      const size_t h = algorithm.compute(points).size();
+      return std::make_pair(h, stats::snapshot());
+    };
+    stats::reset();
+    assert(stats::snapshot().orientations == 0);
+
+    const Points disk = gen::generate(gen::Distribution::Disk, 100000, 7);
+    const auto [quickH, quick] = measure(QuickHullNS::QuickHull(), disk);
+    assert(quick.orientations >= disk.size() && quick.recursions >= quickH);
+    assert(quick.max_depth > 0 && quick.bridge_rounds == 0);
+    uint64_t perLevel = 0;
+    for (uint64_t discarded : quick.discarded_at) {
+      perLevel += discarded;
+    }
+    assert(perLevel == quick.discarded && quick.discarded < disk.size());
+
+    // the counters of other threads are summed, also once they have exited
+    stats::reset();
+    std::thread([&disk] { QuickHullNS::QuickHull().compute(disk); }).join();
+    assert(stats::snapshot().orientations == quick.orientations);
+    assert(stats::snapshot().recursions == quick.recursions);
+    [[maybe_unused]] const auto [parallelH, parallel] =
+        measure(QuickHullNS::ParallelQuickHull(4, 64), disk);
+    assert(parallelH == quickH && parallel.recursions > 0);
+
+    [[maybe_unused]] uint64_t diskRecursions = 0, circleRecursions = 0;
+    for (auto distribution : gen::distributions) {
+      const Points generated = gen::generate(distribution, 100000, 7);
+      const auto [h, mbc] =
+          measure(MarriageNS::MarriageBeforeConquest(), generated);
+      assert(mbc.bridge_rounds > 0);
+      std::cout << "MBC on " << gen::distribution_name(distribution)
+                << ": h = " << h << ", " << mbc.recursions
+                << " recursions, depth " << mbc.max_depth << ", "
+                << mbc.bridge_rounds << " bridge rounds, "
+                << double(mbc.orientations) / generated.size()
+                << " orientation tests per point" << std::endl;
+      if (distribution == gen::Distribution::Disk) {
+        diskRecursions = mbc.recursions;
+      } else if (distribution == gen::Distribution::OnCircle) {
+        circleRecursions = mbc.recursions;
+      }
+    }
+    assert(circleRecursions > diskRecursions);
+  }
+
   // read 1024 points from file and print the hull points
   Points bigPointContainer;
   // do it for all the sizes
@@ -107,16 +225,65 @@ int main() {
       std::cout << "Read " << bigPointContainer.size()
                 << " points from file: " << filename << std::endl;
       Points grahamHull =
-          testAlgorithm(new GrahamScan<Points>(), bigPointContainer,
+          testAlgorithm(GrahamScan<Points>(), bigPointContainer,
                         "Graham Scan on " + s + " shape");
+      Points grahamParHull =
+          testAlgorithm(GrahamScan<Points>(4, 64), bigPointContainer,
+                        "Parallel sort Graham Scan on " + s + " shape");
+      assert(grahamParHull == grahamHull);
       Points quickHull =
-          testAlgorithm(new QuickHullNS::QuickHull(), bigPointContainer,
+          testAlgorithm(QuickHullNS::QuickHull(), bigPointContainer,
                         "QuickHull on " + s + " shape");
+      Points quickParHull =
+          testAlgorithm(QuickHullNS::ParallelQuickHull(4, 64),
+                        bigPointContainer, "Parallel QuickHull on " + s + " shape");
+      assert(quickParHull == quickHull);
+      Points quickInPlaceHull =
+          testAlgorithm(QuickHullNS::InPlaceQuickHull(), bigPointContainer,
+                        "In-place QuickHull on " + s + " shape");
+      assert(quickInPlaceHull == quickHull);
+      Points chanHull = testAlgorithm(ChanNS::Chan(), bigPointContainer,
+                                      "Chan on " + s + " shape");
+      assert(chanHull == grahamHull);
+      Points aklHull = testAlgorithm(
+          AklToussaint<Points>(
+              std::make_shared<VirtualHull<QuickHullNS::QuickHull>>()),
+          bigPointContainer, "Akl-Toussaint + QuickHull on " + s + " shape");
+      assert(aklHull == quickHull);
+      const PointsSoA soaContainer(bigPointContainer);
+      assert(QuickHullNS::QuickHull().compute(soaContainer) == quickHull);
       Points mbc_hull = testAlgorithm(
-          new MarriageNS::MarriageBeforeConquest(), bigPointContainer,
+          MarriageNS::MarriageBeforeConquest(), bigPointContainer,
           "Marriage Before Conquest on " + s + " shape");
+      assert(MarriageNS::MarriageBeforeConquest().compute(soaContainer) ==
+             mbc_hull);
+      assert(MarriageNS::ParallelMarriageBeforeConquest(4, 64).compute(
+                 bigPointContainer) == mbc_hull);
+      for ([[maybe_unused]] const auto &policy : mbcPolicies) {
+        assert(MarriageNS::MarriageBeforeConquest(policy).compute(
+                   bigPointContainer) == mbc_hull);
+        assert(MarriageNS::ParallelMarriageBeforeConquest(3, 16, policy)
+                   .compute(bigPointContainer) == mbc_hull);
+        assert(MarriageNS::MarriageBeforeConquest(policy).compute(
+                   soaContainer) == mbc_hull);
+      }
+      const std::vector<std::pair<std::shared_ptr<ConvexHull<Points>>, Points>>
+          shardedCases = {
+              {std::make_shared<VirtualHull<GrahamScan<Points>>>(), grahamHull},
+              {std::make_shared<VirtualHull<QuickHullNS::QuickHull>>(),
+               quickHull},
+              {std::make_shared<
+                   VirtualHull<MarriageNS::MarriageBeforeConquest>>(),
+               mbc_hull},
+          };
+      for ([[maybe_unused]] const auto &[inner, innerHull] : shardedCases) {
+        assert(ShardedHull(inner, 4, ShardMerge::Tangents, 64)
+                   .compute(bigPointContainer) == grahamHull);
+        assert(ShardedHull(inner, 3, ShardMerge::Union, 64)
+                   .compute(bigPointContainer) == innerHull);
+      }
       Points mbc_hull2 = testAlgorithm(
-          new MarriageNS::MarriageBeforeConquestV2(), bigPointContainer,
+          MarriageNS::MarriageBeforeConquestV2(), bigPointContainer,
           "Marriage Before Conquest V2 on " + s + " shape");
       const std::string label = s + "/" + std::to_string(1 << ith);
 
@@ -127,6 +294,102 @@ int main() {
 
   //==================
 
+  // radix sort keys: signed zeros compare equal, duplicates are kept
+  {
+    Points pattern = {{0.0f, -0.0f}, {-0.0f, 1.0f}, {-1.0f, 0.0f},
+                      {0.0f, 0.0f},  {-0.0f, -0.0f}, {0.0f, 1.0f},
+                      {-1.0f, 0.0f}, {2.0f, -3.0f}};
+    Points zeros;
+    for (int k = 0; k < 128; k++) { // large enough for the radix path
+      zeros.insert(zeros.end(), pattern.begin(), pattern.end());
+    }
+    Points radixSorted = zeros;
+    util::radix_sort(radixSorted);
+    assert(std::is_sorted(radixSorted.begin(), radixSorted.end(), point_cmp));
+    for ([[maybe_unused]] const auto &p : zeros) {
+      assert(std::count(zeros.begin(), zeros.end(), p) ==
+             std::count(radixSorted.begin(), radixSorted.end(), p));
+    }
+  }
+
+  // text parser: same points as the stream reader, errors name their line
+  {
+    for (const std::string file :
+         {"build/tests/square/1024", "build/tests/circle/524288"}) {
+      std::ifstream stream(file);
+      Points expected, parsed, parallel;
+      util::read_points_from_stream(stream, expected);
+      util::parse_points_file(file, parsed, 1);
+      util::parse_points_file(file, parallel, 4);
+      assert(parsed == expected);
+      assert(parallel == expected);
+    }
+
+    const std::string text = "\n2\r\n+1.5 -2\r\n\r\n3e1\t4\n";
+    Points points;
+    util::parse_points(text.data(), text.data() + text.size(), points);
+    assert(points == Points({{1.5f, -2.0f}, {30.0f, 4.0f}}));
+
+    const std::vector<std::pair<std::string, std::string>> errors = {
+        {"3\n1 2\n3 x\n5 6\n", "t:3: invalid y coordinate"},
+        {"3\n1 2\n", "t:1: expected 3 points, found 1"},
+        {"1\n1 2\n3 4\n", "t:1: expected 1 points, found 2"},
+        {"1000000000000\n1 2\n", "t:1: expected 1000000000000 points, found 1"},
+        {"2\n1 2\n\n1 2 3\n", "t:4: unexpected characters after the y "
+                                 "coordinate"},
+        {"two\n", "t:1: invalid number of points"},
+    };
+    for (const auto &[bad, message] : errors) {
+      std::string error;
+      try {
+        util::parse_points(bad.data(), bad.data() + bad.size(), points, 1,
+                           "t");
+      } catch (const std::runtime_error &e) {
+        error = e.what();
+      }
+      assert(error == message);
+    }
+  }
+
+  // binary point files: round trip, flags and rejected files
+  {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "convex_hull_points.bin")
+            .string();
+    Points points;
+    util::read_points_from_file("build/tests/square/1024", points);
+    util::write_point_file(path, points);
+    {
+      util::MappedPoints mapped(path);
+      assert(mapped.points().to_aos() == points);
+      assert(mapped.header().minX <= mapped.header().maxX);
+      assert(!mapped.sorted());
+      assert(QuickHullNS::QuickHull().compute(mapped.points()) ==
+             QuickHullNS::QuickHull().compute(points));
+      assert(GrahamScan<Points>().compute(mapped.points()) ==
+             GrahamScan<Points>().compute(points));
+    }
+
+    std::sort(points.begin(), points.end(), point_cmp);
+    util::write_point_file(path, points);
+    assert(util::MappedPoints(path).sorted());
+
+    std::filesystem::resize_file(path, sizeof(util::PointFileHeader) + 12);
+    [[maybe_unused]] bool rejected = false;
+    try {
+      util::MappedPoints truncated(path);
+    } catch (const std::runtime_error &) {
+      rejected = true;
+    }
+    assert(rejected);
+    std::filesystem::remove(path);
+  }
+
+  // reused by every iteration, so buffers hold stale data of other sizes
+  Workspace workspace;
+  Points into;
+  PointsList intoList;
+  PointsDeque intoDeque;
   std::random_device rd;
   for (int i = 0; i < 1000; i++) {
     std::mt19937 gen(rd());
@@ -145,6 +408,53 @@ int main() {
     auto hull4 = QuickHullNS::QuickHull().compute(pts);
     auto hull5 = MarriageNS::MarriageBeforeConquest().compute(pts);
     auto hull6 = MarriageNS::MarriageBeforeConquestV2().compute(pts);
+    auto hull7 = QuickHullNS::ParallelQuickHull(4, 1).compute(pts);
+    auto hull8 = QuickHullNS::InPlaceQuickHull().compute(pts);
+    auto hull9 = ChanNS::Chan().compute(pts);
+    auto hull10 =
+        AklToussaint<Points>(std::make_shared<VirtualHull<GrahamScan<Points>>>())
+            .compute(pts);
+    auto hull11 =
+        AklToussaint<Points>(
+            std::make_shared<VirtualHull<QuickHullNS::QuickHull>>(), 4)
+            .compute(pts);
+    auto hull12 =
+        AklToussaint<Points>(
+            std::make_shared<
+                VirtualHull<MarriageNS::MarriageBeforeConquest>>())
+            .compute(pts);
+
+    const PointsSoA soa(pts);
+    assert(soa.to_aos() == pts);
+    auto hull13 = QuickHullNS::QuickHull().compute(soa);
+    auto hull14 = MarriageNS::MarriageBeforeConquest().compute(soa);
+    auto hull15 = GrahamScan<Points>().compute(soa);
+
+    Points sorted = pts, parallelSorted = pts;
+    std::sort(sorted.begin(), sorted.end(), point_cmp);
+    parallel_sort(parallelSorted, point_cmp, 3, 1);
+    assert(sorted == parallelSorted);
+    Points radixSorted = pts;
+    util::radix_sort(radixSorted);
+    assert(sorted == radixSorted);
+    auto hull18 = GrahamScan<PointsDeque>(GrahamSort::Radix).compute(pts);
+    auto hull16 = GrahamScan<PointsList>(4, 1).compute(pts);
+    auto hull17 = GrahamScan<PointsDeque>(4, 1).compute(pts);
+
+    for ([[maybe_unused]] const auto &policy : mbcPolicies) {
+      assert(MarriageNS::MarriageBeforeConquest(policy).compute(pts) == hull5);
+      assert(MarriageNS::ParallelMarriageBeforeConquest(4, 1, policy)
+                 .compute(pts) == hull5);
+      assert(MarriageNS::MarriageBeforeConquestV2(policy).compute(pts) ==
+             hull6);
+    }
+
+    for (auto level : {simd::Level::Scalar, simd::Level::SSE4}) {
+      simd::set_level(level);
+      assert(QuickHullNS::QuickHull().compute(pts) == hull4);
+      assert(MarriageNS::MarriageBeforeConquestV2().compute(pts) == hull6);
+    }
+    simd::set_level(simd::detected_level());
 
     assert(util::is_valid_hull(hull, pts));
     assert(util::is_valid_hull(hull2, pts));
@@ -155,8 +465,354 @@ int main() {
     assert(hull == std::vector(hull2.begin(), hull2.end()));
     assert(hull == std::vector(hull3.begin(), hull3.end()));
     assert(hull == hull4);
+    assert(hull4 == hull7);
+    assert(hull4 == hull8);
+    assert(hull == hull9);
+    assert(hull == hull10);
+    assert(hull4 == hull11);
+    assert(hull == hull12);
     assert(hull == hull5);
-    //assert(hull == hull6);
+    assert(hull == hull6);
+    assert(hull4 == hull13);
+    assert(hull == hull14);
+    assert(hull == hull15);
+    assert(hull == std::vector(hull16.begin(), hull16.end()));
+    assert(hull == std::vector(hull17.begin(), hull17.end()));
+    assert(hull == std::vector(hull18.begin(), hull18.end()));
+    for ([[maybe_unused]] unsigned threads : {2, 4, 8}) {
+      assert(ShardedHull(std::make_shared<VirtualHull<QuickHullNS::QuickHull>>(),
+                         threads, ShardMerge::Tangents, 1)
+                 .compute(pts) == hull);
+      assert(ShardedHull(std::make_shared<VirtualHull<QuickHullNS::QuickHull>>(),
+                         threads, ShardMerge::Union, 1)
+                 .compute(pts) == hull4);
+    }
+
+    const std::vector<std::pair<std::shared_ptr<ConvexHull<Points>>, Points>>
+        intoCases = {
+            {std::make_shared<VirtualHull<GrahamScan<Points>>>(), hull},
+            {std::make_shared<VirtualHull<QuickHullNS::QuickHull>>(), hull4},
+            {std::make_shared<VirtualHull<QuickHullNS::ParallelQuickHull>>(4, 1),
+             hull4},
+            {std::make_shared<VirtualHull<QuickHullNS::InPlaceQuickHull>>(),
+             hull4},
+            {std::make_shared<
+                 VirtualHull<MarriageNS::MarriageBeforeConquest>>(),
+             hull},
+            {std::make_shared<
+                 VirtualHull<MarriageNS::MarriageBeforeConquestV2>>(),
+             hull},
+            {std::make_shared<
+                 VirtualHull<MarriageNS::ParallelMarriageBeforeConquest>>(4, 1),
+             hull},
+            {std::make_shared<VirtualHull<ChanNS::Chan>>(), hull},
+            {std::make_shared<VirtualHull<AklToussaint<Points>>>(
+                 std::make_shared<VirtualHull<QuickHullNS::QuickHull>>()),
+             hull4},
+            {std::make_shared<VirtualHull<ShardedHull>>(
+                 std::make_shared<
+                     VirtualHull<MarriageNS::MarriageBeforeConquest>>(),
+                 4, ShardMerge::Tangents, 1),
+             hull},
+        };
+    for (const auto &[algorithm, expected] : intoCases) {
+      algorithm->compute_into(pts, into, workspace);
+      assert(into == expected);
+      assert(algorithm->compute(soa) == expected);
+      assert(algorithm->compute(PointsView(pts)) == expected);
+    }
+    GrahamScan<PointsList>().compute_into(pts, intoList, workspace);
+    assert(hull == std::vector(intoList.begin(), intoList.end()));
+    GrahamScan<PointsDeque>().compute_into(pts, intoDeque, workspace);
+    assert(hull == std::vector(intoDeque.begin(), intoDeque.end()));
+
+    // incremental hull: every prefix, also on a small grid with many
+    // duplicates and collinear points
+    std::uniform_int_distribution<> grid(-3, 3);
+    Points gridPts(len);
+    for (auto &p : gridPts) {
+      p = Point(grid(gen), grid(gen));
+    }
+
+    // parallel Marriage Before Conquest splices exactly what the serial
+    // recursion appends, also on identical points
+    assert(MarriageNS::MarriageBeforeConquest().compute(
+               Points(3, gridPts[0])) == Points{gridPts[0]});
+    for ([[maybe_unused]] const Points &input :
+         {gridPts, Points(3, gridPts[0]), Points(len, gridPts[0])}) {
+      assert(MarriageNS::ParallelMarriageBeforeConquest(4, 1).compute(input) ==
+             MarriageNS::MarriageBeforeConquest().compute(input));
+    }
+
+    for (const Points &input : {pts, gridPts}) {
+      IncrementalHull incremental;
+      Points prefix;
+      for (const auto &p : input) {
+        [[maybe_unused]] const bool changed = incremental.insert(p);
+        assert(changed == !IncrementalHull(prefix).contains(p));
+        prefix.push_back(p);
+        const Points expected = GrahamScan<Points>().compute(prefix);
+        const bool identical = std::all_of(
+            prefix.begin(), prefix.end(),
+            [&](const Point &q) { return q == prefix[0]; });
+        if (prefix.size() >= 3 && !identical) {
+          assert(incremental.hull() == expected);
+          assert(incremental.size() == expected.size());
+        }
+        assert(incremental.contains(p));
+      }
+    }
+
+    // dynamic hull: random insertions and deletions, with the queries
+    // checked against Graham Scan on the current points
+    for (const Points &input : {pts, gridPts}) {
+      DynamicHull dynamic;
+      Points current;
+      std::uniform_int_distribution<size_t> pick(0, input.size() - 1);
+      for (int op = 0; op < 2 * len; op++) {
+        if (current.empty() || gen() % 3 != 0) {
+          const Point &p = input[pick(gen)];
+          dynamic.insert(p);
+          current.push_back(p);
+        } else {
+          const size_t k = gen() % current.size();
+          assert(dynamic.erase(current[k]));
+          current.erase(current.begin() + k);
+        }
+        assert(dynamic.count() == current.size());
+
+        const bool identical = std::all_of(
+            current.begin(), current.end(),
+            [&](const Point &q) { return q == current[0]; });
+        if (current.size() >= 3 && !identical) {
+          const Points expected = GrahamScan<Points>().compute(current);
+          assert(dynamic.hull() == expected);
+          assert(dynamic.size() == expected.size());
+        }
+        if (current.empty()) {
+          assert(!dynamic.erase(input[0]));
+          continue;
+        }
+
+        const Point direction(grid(gen), grid(gen));
+        const auto dotWith = [&](const Point &q) {
+          return double(direction.x) * q.x + double(direction.y) * q.y;
+        };
+        double best = dotWith(current[0]);
+        for (const auto &q : current) {
+          best = std::max(best, dotWith(q));
+        }
+        assert(dotWith(dynamic.extreme(direction)) == best);
+
+        const Point q = input[pick(gen)];
+        [[maybe_unused]] const bool inside =
+            IncrementalHull(current).contains(q);
+        assert(dynamic.contains(q) == inside);
+        const auto tangents = dynamic.tangents(q);
+        assert(tangents.has_value() == !inside);
+        if (tangents && current.size() >= 2) {
+          Points withQ = current;
+          withQ.push_back(q);
+          const Points around = GrahamScan<Points>().compute(withQ);
+          [[maybe_unused]] const size_t at =
+              std::find(around.begin(), around.end(), q) - around.begin();
+          assert(at < around.size());
+          assert(tangents->first ==
+                 around[(at + around.size() - 1) % around.size()]);
+          assert(tangents->second == around[(at + 1) % around.size()]);
+        }
+      }
+    }
+
+    // sliding window: the last `width` points of the stream, then the points
+    // of the last few ticks
+    const size_t width = 1 + gen() % 8;
+    SlidingWindowHull sliding(width);
+    SlidingWindowHull timed;
+    for (int k = 0; k < len; k++) {
+      sliding.push_back(gridPts[k]);
+      const Points window(gridPts.begin() + std::max<int>(0, k + 1 - width),
+                          gridPts.begin() + k + 1);
+      assert(sliding.count() == window.size());
+      assert(sliding.front() == window.front());
+      const bool identical = std::all_of(
+          window.begin(), window.end(),
+          [&](const Point &q) { return q == window[0]; });
+      if (window.size() >= 3 && !identical) {
+        const Points expected = GrahamScan<Points>().compute(window);
+        assert(sliding.hull() == expected);
+        assert(sliding.size() == expected.size());
+      }
+
+      timed.push_back(pts[k], k);
+      timed.expire(k - 4.5);
+      assert(timed.count() == std::min<size_t>(k + 1, 5));
+      if (timed.count() >= 3) {
+        const Points expected = GrahamScan<Points>().compute(
+            Points(pts.begin() + k + 1 - timed.count(), pts.begin() + k + 1));
+        assert(timed.hull() == expected);
+      }
+    }
+
+    // batch: the sets of this iteration, with tiny and large (> small_set)
+    // ones, serial and in parallel chunks
+    PointSets batch;
+    Points both = pts;
+    both.insert(both.end(), gridPts.begin(), gridPts.end());
+    for (const Points &set :
+         {pts, gridPts, Points(), Points(pts.begin(), pts.begin() + 1),
+          Points(gridPts.begin(), gridPts.begin() + 2),
+          Points(gridPts.begin(), gridPts.begin() + 3), both,
+          Points(3, gridPts[0])}) {
+      batch.add(PointsView(set));
+    }
+    for (const BatchHull &batchHull : {BatchHull(), BatchHull(4, 16)}) {
+      PointSets hulls;
+      batchHull.compute(batch, hulls);
+      assert(hulls.size() == batch.size());
+      for (size_t k = 0; k < batch.size(); k++) {
+        [[maybe_unused]] const PointsView hullK = hulls[k];
+        assert(Points(hullK.begin(), hullK.end()) ==
+               GrahamScan<Points>().compute(batch[k].to_aos()));
+      }
+    }
+
+    /* Nearly collinear points, between two points of [1, 1000]^2: the
+     * predicates must give the sign of the cross product computed exactly on
+     * the coordinates scaled to integers (multiples of 2^-33 in this range),
+     * and the algorithms must agree on the hull of the sliver */
+    __extension__ typedef __int128 Exact;
+    const auto exact = [](float v) { return Exact(std::ldexp(double(v), 33)); };
+    [[maybe_unused]] const auto exactSide = [&exact](const Point &p1,
+                                                     const Point &p2,
+                                                     const Point &p3) {
+      return (exact(p3.x) - exact(p2.x)) * (exact(p1.y) - exact(p2.y)) -
+             (exact(p3.y) - exact(p2.y)) * (exact(p1.x) - exact(p2.x));
+    };
+    [[maybe_unused]] const auto sameSign = [](Exact side, double filtered) {
+      return (side > 0) == (filtered > 0) && (side < 0) == (filtered < 0);
+    };
+    std::uniform_real_distribution<> corner(1, 1000);
+    std::uniform_real_distribution<> along(0, 1);
+    const Point a(corner(gen), corner(gen)), b(corner(gen), corner(gen));
+    Points sliver = {a, b};
+    for (int k = 0; k < len; k++) {
+      const double t = along(gen);
+      sliver.emplace_back(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y));
+    }
+    for (size_t k = 2; k < sliver.size(); k++) {
+      [[maybe_unused]] const Point &p = sliver[k];
+      assert(sameSign(exactSide(a, b, p), util::sidedness(a, b, p)));
+      assert(sameSign(exactSide(p, a, b), util::sidedness(p, a, b)));
+      assert(sameSign(exactSide(sliver[k - 2], sliver[k - 1], p),
+                      util::sidedness(sliver[k - 2], sliver[k - 1], p)));
+      assert(util::isLeft(a, b, p) == (exactSide(a, b, p) > 0));
+      assert(sameSign(-exactSide(a, b, p), util::cross(a, p, a, b)));
+    }
+    const Points sliverHull = GrahamScan<Points>().compute(sliver);
+    assert(sliverHull.size() < 3 || util::is_valid_hull(sliverHull, sliver));
+    assert(QuickHullNS::QuickHull().compute(sliver) == sliverHull);
+    assert(QuickHullNS::InPlaceQuickHull().compute(sliver) == sliverHull);
+    assert(MarriageNS::MarriageBeforeConquest().compute(sliver) == sliverHull);
+    assert(MarriageNS::ParallelMarriageBeforeConquest(4, 1).compute(sliver) ==
+           sliverHull);
+    assert(MarriageNS::MarriageBeforeConquestV2().compute(sliver) ==
+           sliverHull);
+    assert(ChanNS::Chan().compute(sliver) == sliverHull);
+    IncrementalHull incrementalSliver;
+    for (const auto &p : sliver) {
+      incrementalSliver.insert(p);
+    }
+    assert(incrementalSliver.hull() == sliverHull);
+
+    /* The same far from the origin, between two points of [-1e6, 1e6]^2
+     * (multiples of 2^-40 unless a coordinate is below 2^-17): there the
+     * rounded distances of the points exactly left of a line can all be below
+     * -1, which QuickHull must not take for an empty side */
+    const auto exactFar = [](float v) {
+      const double scaled = std::ldexp(double(v), 40);
+      assert(scaled == std::trunc(scaled));
+      return Exact(scaled);
+    };
+    std::uniform_real_distribution<> farCorner(-1e6, 1e6);
+    const Point c(farCorner(gen), farCorner(gen)),
+        d(farCorner(gen), farCorner(gen));
+    Points farSliver = {c, d};
+    for (int k = 0; k < len; k++) {
+      const double t = along(gen);
+      farSliver.emplace_back(c.x + t * (d.x - c.x), c.y + t * (d.y - c.y));
+      const Point &p = farSliver.back();
+      [[maybe_unused]] const Exact side = (exactFar(p.x) - exactFar(d.x)) *
+                             (exactFar(c.y) - exactFar(d.y)) -
+                         (exactFar(p.y) - exactFar(d.y)) *
+                             (exactFar(c.x) - exactFar(d.x));
+      assert(sameSign(side, util::sidedness(c, d, p)));
+    }
+    for (const Points &input :
+         {farSliver, Points{{-1077310, -4391120},
+                            {-5557509, 5785587},
+                            {-1539783.12f, -3340619.25f},
+                            {-1405996.12f, -3644514.25f}}}) {
+      const Points farHull = GrahamScan<Points>().compute(input);
+      assert(farHull.size() < 3 || util::is_valid_hull(farHull, input));
+      assert(QuickHullNS::QuickHull().compute(input) == farHull);
+      assert(QuickHullNS::QuickHull().compute(PointsSoA(input)) == farHull);
+      assert(QuickHullNS::ParallelQuickHull(4, 1).compute(input) == farHull);
+      assert(QuickHullNS::InPlaceQuickHull().compute(input) == farHull);
+      assert(MarriageNS::MarriageBeforeConquest().compute(input) == farHull);
+      assert(ChanNS::Chan().compute(input) == farHull);
+    }
+
+    /* Other coordinate types: double copies of float points have the same
+     * hull, and so do int32 copies of integer points. The double predicates
+     * are checked on a sliver of double points (multiples of 2^-53 here),
+     * and the int32 ones up to their 2^30 bound */
+    [[maybe_unused]] const auto asDouble = [](const Points &points) {
+      DoublePoints converted;
+      for (const auto &p : points) {
+        converted.emplace_back(p.x, p.y);
+      }
+      return converted;
+    };
+    for ([[maybe_unused]] const Points &input : {pts, gridPts, sliver}) {
+      assert(GrahamScan<DoublePoints>().compute(asDouble(input)) ==
+             asDouble(GrahamScan<Points>().compute(input)));
+    }
+    assert(GrahamScan<GridPoints>().compute(util::to_grid(gridPts, 1)) ==
+           util::to_grid(GrahamScan<Points>().compute(gridPts), 1));
+
+    // sharded: duplicates and collinear points across the shard boundaries
+    for ([[maybe_unused]] const Points &input : {gridPts, both, sliver}) {
+      assert(ShardedHull(std::make_shared<VirtualHull<GrahamScan<Points>>>(),
+                         4, ShardMerge::Tangents, 1)
+                 .compute(input) == GrahamScan<Points>().compute(input));
+    }
+
+    const auto exactDouble = [](double v) { return Exact(std::ldexp(v, 53)); };
+    const DoublePoint da(a.x, a.y), db(b.x, b.y);
+    DoublePoints doubleSliver = {da, db};
+    for (int k = 0; k < len; k++) {
+      const double t = along(gen);
+      doubleSliver.emplace_back(da.x + t * (db.x - da.x),
+                                da.y + t * (db.y - da.y));
+      const DoublePoint &p = doubleSliver.back();
+      [[maybe_unused]] const Exact side =
+          (exactDouble(p.x) - exactDouble(db.x)) *
+              (exactDouble(da.y) - exactDouble(db.y)) -
+          (exactDouble(p.y) - exactDouble(db.y)) *
+              (exactDouble(da.x) - exactDouble(db.x));
+      assert(sameSign(side, util::sidedness(da, db, p)));
+    }
+
+    std::uniform_int_distribution<int32_t> wide(-(1 << 30) + 1, (1 << 30) - 1);
+    for (int k = 0; k < len; k++) {
+      const GridPoint p1(wide(gen), wide(gen)), p2(wide(gen), wide(gen)),
+          p3(wide(gen), wide(gen));
+      [[maybe_unused]] const Exact side =
+          (Exact(p3.x) - p2.x) * (Exact(p1.y) - p2.y) -
+          (Exact(p3.y) - p2.y) * (Exact(p1.x) - p2.x);
+      assert(side == util::sidedness(p1, p2, p3));
+    }
   }
 
   return 0;
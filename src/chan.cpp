@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <chan.hpp>
+#include <graham_scan.hpp>
+#include <util.hpp>
+
+using namespace ChanNS;
+
+namespace {
+double distance2(const Point &a, const Point &b) {
+  const double dx = a.x - b.x;
+  const double dy = a.y - b.y;
+  return dx * dx + dy * dy;
+}
+
+/* Whether c is a better wrapping candidate than best, as seen from p: c is
+ * left of the line p -> best, or on it but farther away (so that collinear
+ * points are skipped, as Graham Scan does) */
+bool better(const Point &p, const Point &best, const Point &c) {
+  double side = util::sidedness(p, best, c);
+  return side > 0 || (side == 0 && distance2(p, c) > distance2(p, best));
+}
+
+/* Tangent from p to the (clockwise) hull by checking every vertex.
+ * Returns hull.size() if every vertex coincides with p. */
+size_t tangentLinear(const Points &hull, const Point &p) {
+  size_t best = hull.size();
+  for (size_t i = 0; i < hull.size(); ++i) {
+    if (hull[i] == p) {
+      continue;
+    }
+    if (best == hull.size() || better(p, hull[best], hull[i])) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+/* Binary search of the vertex v of the (clockwise) hull such that the whole
+ * hull lies right of p -> v. This is the classic left tangent search on a
+ * counter-clockwise polygon, applied to the reversed hull.
+ * Returns hull.size() if the search does not converge (degenerate input). */
+size_t tangentBinary(const Points &hull, const Point &p) {
+  const size_t n = hull.size();
+  auto index = [n](size_t i) { return (n - i % n) % n; };
+  auto V = [&](size_t i) -> const Point & { return hull[index(i)]; };
+  auto above = [&p](const Point &a, const Point &b) {
+    return util::sidedness(p, a, b) > 0;
+  };
+  auto below = [&p](const Point &a, const Point &b) {
+    return util::sidedness(p, a, b) < 0;
+  };
+
+  if (above(V(n - 1), V(0)) && !below(V(1), V(0))) {
+    return index(0);
+  }
+
+  // the search halves [a, b) at every step, allow a few extra iterations
+  size_t budget = 4;
+  for (size_t k = n; k > 0; k >>= 1) {
+    budget += 2;
+  }
+
+  size_t a = 0, b = n;
+  for (size_t step = 0; step < budget; ++step) {
+    size_t c = (a + b) / 2;
+    bool dnC = below(V(c + 1), V(c));
+    if (above(V(c + n - 1), V(c)) && !dnC) {
+      return index(c);
+    }
+    bool dnA = below(V(a + 1), V(a));
+    if (dnA) {
+      if (!dnC || below(V(a), V(c))) {
+        b = c;
+      } else {
+        a = c;
+      }
+    } else {
+      if (dnC || !above(V(a), V(c))) {
+        a = c;
+      } else {
+        b = c;
+      }
+    }
+  }
+  return n;
+}
+
+/* Tangent from p to the hull of another group */
+size_t tangent(const Points &hull, const Point &p) {
+  const size_t n = hull.size();
+  if (n <= 3) {
+    return tangentLinear(hull, p);
+  }
+
+  size_t t = tangentBinary(hull, p);
+  if (t == n) {
+    return tangentLinear(hull, p);
+  }
+
+  // a tangent has both neighbours on the right (or on the line)
+  const Point &prev = hull[(t + n - 1) % n];
+  const Point &next = hull[(t + 1) % n];
+  if (hull[t] == p || util::sidedness(p, hull[t], prev) > 0 ||
+      util::sidedness(p, hull[t], next) > 0) {
+    return tangentLinear(hull, p);
+  }
+
+  // the tangent line may contain a whole edge: take its farthest end
+  if (better(p, hull[t], next)) {
+    return (t + 1) % n;
+  }
+  if (better(p, hull[t], prev)) {
+    return (t + n - 1) % n;
+  }
+  return t;
+}
+} // namespace
+
+bool Chan::wrap(const Points &points, size_t m, Points &hull,
+                Workspace &workspace) const {
+  const size_t n = points.size();
+
+  /* 1. Compute the hull of each group of (at most) m points */
+  GrahamScan<Points> graham;
+  const size_t groups = (n + m - 1) / m;
+  auto hulls = [&workspace](size_t g) -> Points & {
+    return workspace.points(1 + g);
+  };
+  Points &group = workspace.points(0);
+  for (size_t g = 0; g < groups; ++g) {
+    group.assign(points.begin() + g * m,
+                 points.begin() + std::min(n, (g + 1) * m));
+    graham.compute_into(group, hulls(g), workspace.nested(0));
+  }
+
+  /* 2. Start from the leftmost (and topmost) point, as Graham Scan does */
+  size_t start = 0;
+  for (size_t i = 1; i < n; ++i) {
+    const Point &p = points[i];
+    if (p.x < points[start].x ||
+        (p.x == points[start].x && p.y > points[start].y)) {
+      start = i;
+    }
+  }
+  size_t g = start / m;
+  size_t i = std::find(hulls(g).begin(), hulls(g).end(), points[start]) -
+             hulls(g).begin();
+
+  /* 3. Wrap clockwise for at most m steps */
+  hull.clear();
+  for (size_t step = 0; step < m; ++step) {
+    const Point p = hulls(g)[i];
+    hull.push_back(p);
+
+    size_t bestG = groups, bestI = 0;
+    auto consider = [&](size_t cg, size_t ci) {
+      const Point &c = hulls(cg)[ci];
+      if (c == p) {
+        return;
+      }
+      if (bestG == groups || better(p, hulls(bestG)[bestI], c)) {
+        bestG = cg;
+        bestI = ci;
+      }
+    };
+
+    // p is a vertex of its own group hull: the tangent is its successor
+    consider(g, (i + 1) % hulls(g).size());
+    for (size_t h = 0; h < groups; ++h) {
+      if (h == g) {
+        continue;
+      }
+      size_t t = tangent(hulls(h), p);
+      if (t < hulls(h).size()) {
+        consider(h, t);
+      }
+    }
+
+    if (bestG == groups || hulls(bestG)[bestI] == hull.front()) {
+      return true;
+    }
+    g = bestG;
+    i = bestI;
+  }
+
+  return false;
+}
+
+Points Chan::compute(const Points &points) const {
+  Workspace workspace;
+  Points hull;
+  compute_into(points, hull, workspace);
+  return hull;
+}
+
+void Chan::compute_into(const Points &points, Points &hull,
+                        Workspace &workspace) const {
+  if (points.size() <= 2) {
+    hull.assign(points.begin(), points.end());
+    return;
+  }
+
+  /* Square the guess of h until the wrapping closes the hull */
+  size_t m = std::min<size_t>(16, points.size());
+  while (!wrap(points, m, hull, workspace)) {
+    m = std::min(m * m, points.size());
+  }
+}
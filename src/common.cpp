@@ -1,28 +1,118 @@
+#include <algorithm>
 #include <common.hpp>
 #include <iostream>
+#include <memory>
 #include <sstream>
 
-Point::Point(float x, float y) : x(x), y(y) {}
-Point::Point() : x(0), y(0) {}
-bool Point::operator==(Point const& other) const {
-    return this->x == other.x && this->y == other.y;
-}
-
-bool Point::operator!=(Point const& other) const {
-    return !(*this == other);
-}
-
-std::string Point::to_string() const {
+template <typename T>
+std::string BasicPoint<T>::to_string() const {
   std::ostringstream o;
   o << "(" << this->x << ", " << this->y << ")";
   return o.str();
 }
 
+template class BasicPoint<float>;
+template class BasicPoint<int32_t>;
+template class BasicPoint<double>;
+
 void showValue(const Point &pt, std::ostream &o) {
   o << "(" << pt.x << "," << pt.y << ")";
 }
 
-Line::Line() : p1(), p2() {}
-Line::Line(Point const& a, Point const& b) : p1(a), p2(b) {}
-
 Triangle::Triangle(Point const& a, Point const& b, Point const& c) : p1(a), p2(b), p3(c) {}
+
+namespace {
+// a multiple of 16 floats keeps the y array 64-byte aligned too
+constexpr std::size_t SOA_ALIGN = 64;
+constexpr std::size_t SOA_BLOCK = SOA_ALIGN / sizeof(float);
+} // namespace
+
+PointsSoA::PointsSoA(const std::vector<Point>& points) {
+    reserve(points.size());
+    for (const auto& p : points) {
+        push_back(p);
+    }
+}
+
+PointsSoA::PointsSoA(const PointsSoA& other) {
+    reserve(other.n);
+    std::copy(other.xs(), other.xs() + other.n, data);
+    std::copy(other.ys(), other.ys() + other.n, data + cap);
+    n = other.n;
+}
+
+PointsSoA::PointsSoA(PointsSoA&& other) noexcept
+    : raw(other.raw), data(other.data), n(other.n), cap(other.cap) {
+    other.raw = nullptr;
+    other.data = nullptr;
+    other.n = other.cap = 0;
+}
+
+PointsSoA& PointsSoA::operator=(PointsSoA other) noexcept {
+    std::swap(raw, other.raw);
+    std::swap(data, other.data);
+    std::swap(n, other.n);
+    std::swap(cap, other.cap);
+    return *this;
+}
+
+PointsSoA::~PointsSoA() { ::operator delete(raw); }
+
+void PointsSoA::reserve(std::size_t capacity) {
+    if (capacity <= cap) {
+        return;
+    }
+    capacity = (capacity + SOA_BLOCK - 1) / SOA_BLOCK * SOA_BLOCK;
+
+    // over-allocate and align by hand: the aligned operator new goes through
+    // a much slower allocator path, and the recursions create many small sets
+    void* grownRaw = ::operator new(2 * capacity * sizeof(float) + SOA_ALIGN);
+    std::size_t space = 2 * capacity * sizeof(float) + SOA_ALIGN;
+    void* aligned = grownRaw;
+    std::align(SOA_ALIGN, 2 * capacity * sizeof(float), aligned, space);
+    float* grown = static_cast<float*>(aligned);
+
+    std::copy(xs(), xs() + n, grown);
+    std::copy(ys(), ys() + n, grown + capacity);
+    ::operator delete(raw);
+    raw = grownRaw;
+    data = grown;
+    cap = capacity;
+}
+
+std::vector<Point> PointsSoA::to_aos() const {
+    std::vector<Point> points;
+    points.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        points.emplace_back(data[i], data[cap + i]);
+    }
+    return points;
+}
+
+std::vector<Point>& Workspace::points(std::size_t i) {
+    while (pointBuffers.size() <= i) {
+        pointBuffers.emplace_back();
+    }
+    return pointBuffers[i];
+}
+
+PointsSoA& Workspace::soa(std::size_t i) {
+    while (soaBuffers.size() <= i) {
+        soaBuffers.emplace_back();
+    }
+    return soaBuffers[i];
+}
+
+std::vector<double>& Workspace::values(std::size_t i) {
+    while (valueBuffers.size() <= i) {
+        valueBuffers.emplace_back();
+    }
+    return valueBuffers[i];
+}
+
+Workspace& Workspace::nested(std::size_t i) {
+    while (workspaces.size() <= i) {
+        workspaces.push_back(std::make_unique<Workspace>());
+    }
+    return *workspaces[i];
+}
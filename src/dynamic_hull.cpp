@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <dynamic_hull.hpp>
+#include <util.hpp>
+
+namespace {
+bool lexLess(const Point &p, const Point &q) {
+  return p.x < q.x || (p.x == q.x && p.y < q.y);
+}
+
+/* r is on or above the line through p and q, p coming first */
+bool onOrAbove(const Point &p, const Point &q, const Point &r) {
+  return util::sidedness(p, q, r) >= 0;
+}
+
+Point mirror(const Point &p) { return Point(p.x, -p.y); }
+
+double dot(const Point &u, const Point &p, const Point &q) {
+  return double(u.x) * (double(q.x) - p.x) + double(u.y) * (double(q.y) - p.y);
+}
+
+/* Whether the lines (c, d) and (e, f), not parallel, cross lexicographically
+ * before or at s */
+bool crossUpTo(const Point &c, const Point &d, const Point &e, const Point &f,
+               const Point &s) {
+  const double dx1 = double(d.x) - c.x, dy1 = double(d.y) - c.y;
+  const double dx2 = double(f.x) - e.x, dy2 = double(f.y) - e.y;
+  const double t =
+      ((double(e.x) - c.x) * dy2 - (double(e.y) - c.y) * dx2) /
+      (dx1 * dy2 - dy1 * dx2);
+  const double x = c.x + t * dx1;
+  return x < s.x || (x == s.x && c.y + t * dy1 <= s.y);
+}
+} // namespace
+
+void DynamicHull::insert(const Point &p) {
+  upper.insert(p);
+  lower.insert(mirror(p));
+  ++points;
+}
+
+bool DynamicHull::erase(const Point &p) {
+  if (!upper.erase(p)) {
+    return false;
+  }
+  lower.erase(mirror(p));
+  --points;
+  return true;
+}
+
+void DynamicHull::clear() {
+  upper.clear();
+  lower.clear();
+  points = 0;
+}
+
+size_t DynamicHull::size() const {
+  if (empty()) {
+    return 0;
+  }
+  if (upper.size() == 1) {
+    return 1;
+  }
+  /* Both chains start with the leftmost points, bottom and top (once if they
+   * are the same), and the upper one ends with the rightmost top point where
+   * the lower one ends with the rightmost bottom one */
+  size_t n = upper.size() + lower.size();
+  n -= upper.min() == mirror(lower.min()) ? 1 : 2;
+  n -= upper.max() == mirror(lower.max());
+  return n;
+}
+
+Points DynamicHull::hull() const {
+  Points hull;
+  if (empty()) {
+    return hull;
+  }
+  Points chain;
+  upper.vertices(chain);
+  // the upper chain goes up the vertical left edge, if any: start at its top
+  const bool vertical = chain.size() > 1 && chain[0].x == chain[1].x;
+  hull.assign(chain.begin() + vertical, chain.end());
+
+  chain.clear();
+  lower.vertices(chain);
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    const Point p = mirror(*it);
+    // skip the end points shared with the upper chain
+    if (p != hull.back() && p != hull.front()) {
+      hull.push_back(p);
+    }
+  }
+  return hull;
+}
+
+bool DynamicHull::contains(const Point &p) const {
+  return !empty() && !upper.neighbours(p).vertex &&
+         !lower.neighbours(mirror(p)).vertex;
+}
+
+Point DynamicHull::extreme(const Point &direction) const {
+  if (direction.y >= 0) {
+    return upper.extreme(direction);
+  }
+  return mirror(lower.extreme(mirror(direction)));
+}
+
+std::optional<std::pair<Point, Point>>
+DynamicHull::tangents(const Point &p) const {
+  if (empty()) {
+    return std::nullopt;
+  }
+  const auto up = upper.neighbours(p);
+  const auto down = lower.neighbours(mirror(p));
+  if (!up.vertex && !down.vertex) {
+    return std::nullopt;
+  }
+
+  /* Clockwise, the hull of the points and p is its upper chain followed by
+   * its lower chain backwards. Where p ends a chain, its neighbour is on the
+   * other one, or across a vertical edge at the right. */
+  Point before, after;
+  if (up.vertex && up.left) {
+    before = *up.left;
+  } else if (down.vertex && down.right) {
+    before = mirror(*down.right);
+  } else {
+    before = upper.max();
+  }
+  if (up.vertex && up.right) {
+    after = *up.right;
+  } else if (down.vertex && down.left) {
+    after = mirror(*down.left);
+  } else {
+    after = mirror(lower.max());
+  }
+  return std::make_pair(before, after);
+}
+
+void DynamicHull::Chain::insert(const Point &p) {
+  if (root < 0) {
+    root = allocate();
+    Node &leaf = nodes[root];
+    leaf.copies = 1;
+    leaf.a = leaf.b = leaf.min = leaf.max = p;
+    return;
+  }
+  reshaped = false;
+  root = insertAt(root, p);
+}
+
+
+bool DynamicHull::Chain::erase(const Point &p) {
+  if (root < 0) {
+    return false;
+  }
+  reshaped = false;
+  found = false;
+  root = eraseAt(root, p);
+  return found;
+}
+
+void DynamicHull::Chain::clear() {
+  nodes.clear();
+  freeNodes.clear();
+  root = -1;
+}
+
+int DynamicHull::Chain::allocate() {
+  if (freeNodes.empty()) {
+    nodes.emplace_back();
+    return nodes.size() - 1;
+  }
+  const int v = freeNodes.back();
+  freeNodes.pop_back();
+  nodes[v] = Node();
+  return v;
+}
+
+int DynamicHull::Chain::insertAt(int v, const Point &p) {
+  if (isLeaf(v)) {
+    const Point q = nodes[v].a;
+    if (q == p) {
+      ++nodes[v].copies;
+      return v;
+    }
+    // the leaf becomes the sibling of the new one, under a new internal node
+    const int leaf = allocate();
+    nodes[leaf].copies = 1;
+    nodes[leaf].a = nodes[leaf].b = nodes[leaf].min = nodes[leaf].max = p;
+    const int parent = allocate();
+    nodes[parent].left = lexLess(p, q) ? leaf : v;
+    nodes[parent].right = lexLess(p, q) ? v : leaf;
+    update(parent);
+    reshaped = true;
+    return parent;
+  }
+
+  const int left = nodes[v].left;
+  const int right = nodes[v].right;
+  if (!lexLess(nodes[left].max, p)) {
+    const int child = insertAt(left, p);
+    nodes[v].left = child;
+  } else {
+    const int child = insertAt(right, p);
+    nodes[v].right = child;
+  }
+  return reshaped ? rebalance(v) : v;
+}
+
+int DynamicHull::Chain::eraseAt(int v, const Point &p) {
+  if (isLeaf(v)) {
+    if (nodes[v].a != p) {
+      return v;
+    }
+    found = true;
+    if (--nodes[v].copies > 0) {
+      return v;
+    }
+    freeNodes.push_back(v);
+    reshaped = true;
+    return -1;
+  }
+
+  const int left = nodes[v].left;
+  const int right = nodes[v].right;
+  if (!lexLess(nodes[left].max, p)) {
+    const int child = eraseAt(left, p);
+    if (child < 0) {
+      // the sibling takes the place of the parent
+      freeNodes.push_back(v);
+      return right;
+    }
+    nodes[v].left = child;
+  } else {
+    const int child = eraseAt(right, p);
+    if (child < 0) {
+      freeNodes.push_back(v);
+      return left;
+    }
+    nodes[v].right = child;
+  }
+  return reshaped ? rebalance(v) : v;
+}
+
+int DynamicHull::Chain::rotateLeft(int v) {
+  const int r = nodes[v].right;
+  nodes[v].right = nodes[r].left;
+  nodes[r].left = v;
+  update(v);
+  update(r);
+  return r;
+}
+
+int DynamicHull::Chain::rotateRight(int v) {
+  const int l = nodes[v].left;
+  nodes[v].left = nodes[l].right;
+  nodes[l].right = v;
+  update(v);
+  update(l);
+  return l;
+}
+
+int DynamicHull::Chain::rebalance(int v) {
+  const int left = nodes[v].left;
+  const int right = nodes[v].right;
+  const int balance = nodes[left].height - nodes[right].height;
+  if (balance > 1) {
+    if (nodes[nodes[left].left].height < nodes[nodes[left].right].height) {
+      nodes[v].left = rotateLeft(left);
+    }
+    return rotateRight(v);
+  }
+  if (balance < -1) {
+    if (nodes[nodes[right].right].height < nodes[nodes[right].left].height) {
+      nodes[v].right = rotateRight(right);
+    }
+    return rotateLeft(v);
+  }
+  update(v);
+  return v;
+}
+
+void DynamicHull::Chain::update(int v) {
+  bridge(v);
+  Node &n = nodes[v];
+  const Node &left = nodes[n.left];
+  const Node &right = nodes[n.right];
+  n.height = 1 + std::max(left.height, right.height);
+  n.min = left.min;
+  n.max = right.max;
+  n.leftCount = countUpTo(n.left, n.a);
+  n.rightSkip = countUpTo(n.right, n.b) - 1;
+  n.hullSize = n.leftCount + right.hullSize - n.rightSkip;
+}
+
+/* The bridge (a, b) joins the upper hulls of the children, at a on the left
+ * and b on the right; with collinear points, a is the leftmost one and b the
+ * rightmost one. The search goes down both children at once, keeping a in the
+ * left subtree and b in the right one. At an internal node, its own bridge
+ * (c, d) is an edge of the hull of its subtree, and a is either up to c or
+ * from d on. */
+void DynamicHull::Chain::bridge(int v) {
+  int l = nodes[v].left;
+  int r = nodes[v].right;
+  const Point split = nodes[l].max;
+  while (!isLeaf(l) || !isLeaf(r)) {
+    if (isLeaf(l)) {
+      // tangent from a to the right hull
+      const Node &right = nodes[r];
+      r = onOrAbove(right.a, right.b, nodes[l].a) ? right.right : right.left;
+    } else if (isLeaf(r)) {
+      // tangent from b to the left hull
+      const Node &left = nodes[l];
+      l = onOrAbove(left.a, left.b, nodes[r].a) ? left.left : left.right;
+    } else {
+      const Node &left = nodes[l];
+      const Node &right = nodes[r];
+      /* A point of the right set on or above the line (c, d) means that a is
+       * up to c, and a point of the left set on or above (e, f) that b is from
+       * f on. Otherwise the lines cross between the two edges: the side of
+       * the split they cross on rules out one half. */
+      const bool upToC = onOrAbove(left.a, left.b, right.a) ||
+                         onOrAbove(left.a, left.b, right.b);
+      const bool fromF = onOrAbove(right.a, right.b, left.a) ||
+                         onOrAbove(right.a, right.b, left.b);
+      if (upToC || fromF) {
+        l = upToC ? left.left : l;
+        r = fromF ? right.right : r;
+      } else if (crossUpTo(left.a, left.b, right.a, right.b, split)) {
+        l = left.right;
+      } else {
+        r = right.left;
+      }
+    }
+  }
+  nodes[v].a = nodes[l].a;
+  nodes[v].b = nodes[r].a;
+}
+
+size_t DynamicHull::Chain::countUpTo(int v, const Point &p) const {
+  size_t count = 0;
+  while (!isLeaf(v)) {
+    const Node &n = nodes[v];
+    if (lexLess(p, n.b)) {
+      if (!lexLess(p, n.a)) {
+        return count + n.leftCount;
+      }
+      v = n.left;
+    } else {
+      count += n.leftCount;
+      count -= n.rightSkip;
+      v = n.right;
+    }
+  }
+  return count + !lexLess(p, nodes[v].a);
+}
+
+void DynamicHull::Chain::vertices(Points &out) const {
+  if (root >= 0) {
+    out.reserve(out.size() + size());
+    collect(root, nullptr, nullptr, out);
+  }
+}
+
+/* Vertices of the hull of v between from and to (included), which are either
+ * unbounded or vertices themselves */
+void DynamicHull::Chain::collect(int v, const Point *from, const Point *to,
+                                 Points &out) const {
+  const Node &n = nodes[v];
+  if (isLeaf(v)) {
+    out.push_back(n.a);
+    return;
+  }
+  if (!from || !lexLess(n.a, *from)) {
+    collect(n.left, from, to && lexLess(*to, n.a) ? to : &n.a, out);
+  }
+  if (!to || !lexLess(*to, n.b)) {
+    collect(n.right, from && lexLess(n.b, *from) ? from : &n.b, to, out);
+  }
+}
+
+Point DynamicHull::Chain::extreme(const Point &direction) const {
+  return extremeAt(root, direction);
+}
+
+/* The dot product increases along the hull up to the extreme vertex, then
+ * decreases: the bridge tells the side, and the extreme vertex of the child
+ * is clamped to its part of the hull. It is flat along a vertical left edge
+ * when the direction is horizontal, and only there. */
+Point DynamicHull::Chain::extremeAt(int v, const Point &direction) const {
+  const Node &n = nodes[v];
+  if (isLeaf(v)) {
+    return n.a;
+  }
+  const double rise = dot(direction, n.a, n.b);
+  if (rise > 0 || (rise == 0 && direction.x > 0)) {
+    const Point p = extremeAt(n.right, direction);
+    return lexLess(p, n.b) ? n.b : p;
+  }
+  const Point p = extremeAt(n.left, direction);
+  return lexLess(n.a, p) ? n.a : p;
+}
+
+/* Contact of the tangent from p, right of every point of v */
+Point DynamicHull::Chain::tangentFromRight(int v, const Point &p) const {
+  while (!isLeaf(v)) {
+    const Node &n = nodes[v];
+    v = onOrAbove(n.a, n.b, p) ? n.left : n.right;
+  }
+  return nodes[v].a;
+}
+
+/* Contact of the tangent from p, left of every point of v */
+Point DynamicHull::Chain::tangentFromLeft(int v, const Point &p) const {
+  while (!isLeaf(v)) {
+    const Node &n = nodes[v];
+    v = onOrAbove(n.a, n.b, p) ? n.right : n.left;
+  }
+  return nodes[v].a;
+}
+
+/* The points left of p are O(log n) subtrees hanging off its search path, as
+ * are the points right of it. The neighbour of p on either side is the best
+ * contact among those of the tangents to these subtrees. */
+DynamicHull::Chain::Neighbours
+DynamicHull::Chain::neighbours(const Point &p) const {
+  Neighbours result{true, std::nullopt, std::nullopt};
+  if (root < 0) {
+    return result;
+  }
+  auto &left = result.left;
+  auto &right = result.right;
+  const auto leftCandidate = [&](const Point &t) {
+    const double side = left ? util::sidedness(*left, p, t) : 1;
+    if (side > 0 || (side == 0 && lexLess(t, *left))) {
+      left = t;
+    }
+  };
+  const auto rightCandidate = [&](const Point &t) {
+    const double side = right ? util::sidedness(p, *right, t) : 1;
+    if (side > 0 || (side == 0 && lexLess(*right, t))) {
+      right = t;
+    }
+  };
+
+  int v = root;
+  while (!isLeaf(v)) {
+    const Node &n = nodes[v];
+    if (lexLess(nodes[n.left].max, p)) {
+      leftCandidate(tangentFromRight(n.left, p));
+      v = n.right;
+    } else {
+      rightCandidate(tangentFromLeft(n.right, p));
+      v = n.left;
+    }
+  }
+  const Point &q = nodes[v].a;
+  if (q == p) {
+    return {false, std::nullopt, std::nullopt};
+  }
+  if (lexLess(q, p)) {
+    leftCandidate(q);
+  } else {
+    rightCandidate(q);
+  }
+  result.vertex = !left || !right || util::isLeft(*left, *right, p);
+  return result;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <generate.hpp>
+#include <numeric>
+#include <thread>
+#include <thread_pool.hpp>
+
+namespace gen {
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+uint64_t mix(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+/* SplitMix64 stream keyed by (seed, stream, index): one per point, so any
+ * point can be drawn without the ones before it */
+class Rng {
+public:
+  Rng(uint64_t seed, uint64_t stream, uint64_t index)
+      : state(mix(mix(seed ^ stream * 0xd1b54a32d192ed03) + index)) {}
+
+  uint64_t next() { return mix(state += 0x9e3779b97f4a7c15); }
+  /* Uniform in [0, 1) */
+  double unit() { return (next() >> 11) * 0x1.0p-53; }
+  double uniform(double lo, double hi) { return lo + (hi - lo) * unit(); }
+  /* Standard normal (Box-Muller) */
+  double normal() {
+    const double r = std::sqrt(-2 * std::log(1 - unit()));
+    return r * std::cos(2 * pi * unit());
+  }
+
+private:
+  uint64_t state;
+};
+
+/* Streams of the keys, besides the one of the points */
+enum Stream : uint64_t { Coordinates = 0, Pool = 1, Centres = 2, Order = 3 };
+
+constexpr size_t clusters = 16;
+
+/* Point i of the distribution, with what the distribution shares between
+ * its points drawn up front */
+class Generator {
+public:
+  Generator(Distribution distribution, size_t n, uint64_t seed)
+      : distribution(distribution), n(n), seed(seed),
+        pool(std::max<size_t>(1, n / 64)) {
+    for (size_t c = 0; c < clusters; c++) {
+      Rng rng(seed, Centres, c);
+      const double x = rng.uniform(-0.8 * radius, 0.8 * radius);
+      centres[c] = Point(x, rng.uniform(-0.8 * radius, 0.8 * radius));
+    }
+
+    /* The parabola strata in the order of an affine permutation, so that the
+     * points are not sorted by x (stride * i fits in 64 bits while n < 2^32) */
+    Rng rng(seed, Order, 0);
+    stride = n > 1 ? (rng.next() % n) | 1 : 1;
+    while (std::gcd(stride, n) != 1) {
+      stride += 2;
+    }
+    offset = n > 0 ? rng.next() % n : 0;
+  }
+
+  Point operator()(size_t i) const {
+    Rng rng(seed, Coordinates, i);
+    switch (distribution) {
+    case Distribution::Disk:
+      return polar(rng, radius * std::sqrt(rng.unit()));
+    case Distribution::Square:
+      return square(rng);
+    case Distribution::Parabola: {
+      const size_t stratum = (stride * i + offset) % n;
+      const double x = -radius + 2 * radius * (stratum + rng.unit()) / n;
+      return Point(x, x * x / radius);
+    }
+    case Distribution::Annulus:
+      return polar(rng, radius * std::sqrt(0.81 + 0.19 * rng.unit()));
+    case Distribution::Gaussian: {
+      const double x = rng.normal() * radius / 3;
+      return Point(x, rng.normal() * radius / 3);
+    }
+    case Distribution::Clustered: {
+      const Point &centre = centres[rng.next() % clusters];
+      const double x = centre.x + rng.normal() * radius / 64;
+      return Point(x, centre.y + rng.normal() * radius / 64);
+    }
+    case Distribution::OnCircle:
+      return polar(rng, radius);
+    case Distribution::Duplicates: {
+      Rng shared(seed, Pool, rng.next() % pool);
+      return square(shared);
+    }
+    case Distribution::Collinear: {
+      // the coordinates are rounded first, so the points are exactly aligned
+      const uint64_t side = rng.next() % 6;
+      const float t = rng.uniform(-radius, radius);
+      switch (side) {
+      case 0:
+        return Point(-radius, t);
+      case 1:
+        return Point(radius, t);
+      case 2:
+        return Point(t, -radius);
+      case 3:
+        return Point(t, radius);
+      case 4:
+        return Point(t, t);
+      default:
+        return Point(t, -t);
+      }
+    }
+    }
+    return Point();
+  }
+
+private:
+  static Point polar(Rng &rng, double r) {
+    const double angle = 2 * pi * rng.unit();
+    return Point(r * std::cos(angle), r * std::sin(angle));
+  }
+
+  static Point square(Rng &rng) {
+    const double x = rng.uniform(-radius, radius);
+    return Point(x, rng.uniform(-radius, radius));
+  }
+
+  Distribution distribution;
+  size_t n;
+  uint64_t seed;
+  size_t pool;
+  size_t stride = 1, offset = 0;
+  Point centres[clusters];
+};
+} // namespace
+
+const char *distribution_name(Distribution distribution) {
+  switch (distribution) {
+  case Distribution::Disk:
+    return "disk";
+  case Distribution::Square:
+    return "square";
+  case Distribution::Parabola:
+    return "parabola";
+  case Distribution::Annulus:
+    return "annulus";
+  case Distribution::Gaussian:
+    return "gaussian";
+  case Distribution::Clustered:
+    return "clustered";
+  case Distribution::OnCircle:
+    return "oncircle";
+  case Distribution::Duplicates:
+    return "duplicates";
+  case Distribution::Collinear:
+    return "collinear";
+  }
+  return "unknown";
+}
+
+Points generate(Distribution distribution, size_t n, uint64_t seed,
+                unsigned threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  const Generator generator(distribution, n, seed);
+  Points points(n);
+  constexpr size_t chunk = 1 << 16;
+  auto fill = [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+      points[i] = generator(i);
+    }
+  };
+
+  if (threads <= 1 || n <= chunk) {
+    fill(0, n);
+    return points;
+  }
+
+  TaskGroup group(ThreadPool::shared(threads));
+  for (size_t first = 0; first < n; first += chunk) {
+    group.run([&, first] { fill(first, std::min(n, first + chunk)); });
+  }
+  group.wait();
+  return points;
+}
+
+} // namespace gen
@@ -2,6 +2,7 @@
 #include <cassert>
 #include <common.hpp>
 #include <graham_scan.hpp>
+#include <parallel_sort.hpp>
 #include <util.hpp>
 #include <vector>
 
@@ -19,20 +20,40 @@ bool point_cmp(const Point &a, const Point &b) {
  * - `1`, meaning that the three points make a right turn, or
  * - `-1`, meaning that they do a left turn
  */
-bool turns(float side, const Point &a, const Point &b, const Point &c) {
-  auto sidedness = util::sidedness(Line(a, c), b);
+template <typename P>
+bool turns(float side, const P &a, const P &b, const P &c) {
+  auto sidedness = util::sidedness(a, c, b);
   return sidedness * side <= 0;
 }
 
-template <typename T>
-void compute_inner(const Points &points, T &half, float side) {
+/* point_cmp for any coordinate type */
+template <typename P>
+bool point_before(const P &a, const P &b) {
+  return a.x != b.x ? a.x < b.x : a.y > b.y;
+}
+
+/* Buffer i of the workspace for float points; there are none for the other
+ * coordinate types, which use `local` instead */
+template <typename P>
+std::vector<P> &scratch(Workspace &workspace, size_t i, std::vector<P> &local) {
+  if constexpr (std::is_same_v<P, Point>) {
+    return workspace.points(i);
+  } else {
+    (void)workspace;
+    (void)i;
+    return local;
+  }
+}
+
+template <typename S, typename T>
+void compute_inner(const S &points, T &half, float side) {
   half.clear();
   half.push_back(points[0]);
   half.push_back(points[1]);
   for (size_t i = 2; i < points.size(); i++) {
     while (half.size() >= 2) {
-      Point const& m1 = half.back();
-      Point const& m2 = *std::prev(half.end(), 2);
+      auto const& m1 = half.back();
+      auto const& m2 = *std::prev(half.end(), 2);
 
       if (turns(side, m2, m1, points[i])) {
         half.pop_back();
@@ -45,8 +66,8 @@ void compute_inner(const Points &points, T &half, float side) {
   }
 }
 
-template<typename T>
-void merge(T &lower, T &upper) {
+template<typename L, typename U>
+void merge(L &lower, U &upper) {
   lower.pop_back();
   for (int i = lower.size() - 2; i >= 0; i--) {
     upper.push_back(lower.back());
@@ -54,32 +75,63 @@ void merge(T &lower, T &upper) {
   }
 }
 
+template <typename T>
+void GrahamScan<T>::sortPoints(std::vector<point_type> &points) const {
+  if constexpr (std::is_same_v<point_type, Point>) {
+    if (sort == GrahamSort::Radix) {
+      util::radix_sort(points);
+    } else {
+      parallel_sort(points, point_cmp, threads, cutoff);
+    }
+  } else {
+    // the radix sort keys are float bits
+    parallel_sort(points, point_before<point_type>, threads, cutoff);
+  }
+}
+
+template<typename T>
+T GrahamScan<T>::compute(const std::vector<point_type> &points) const {
+  Workspace workspace;
+  T hull;
+  compute_into(points, hull, workspace);
+  return hull;
+}
+
 template<typename T>
-T GrahamScan<T>::compute(const std::vector<Point> &points) const {
-  if (points.size() <= 2)
-    return T(points.begin(), points.end());
+void GrahamScan<T>::compute_into(const std::vector<point_type> &points, T &out,
+                                 Workspace &workspace) const {
+  if (points.size() <= 2) {
+    out.assign(points.begin(), points.end());
+    return;
+  }
 
-  std::vector<Point> pts(points.begin(), points.end());
-  std::sort(pts.begin(), pts.end(), point_cmp);
+  std::vector<point_type> sorted, lowerHalf;
+  auto &pts = scratch(workspace, 0, sorted);
+  pts.assign(points.begin(), points.end());
+  sortPoints(pts);
 
-  T upper;
-  compute_inner(pts, upper, 1.0);
-  T lower;
+  // the upper hull is built directly in the output
+  compute_inner(pts, out, 1.0);
+  auto &lower = scratch(workspace, 1, lowerHalf);
   compute_inner(pts, lower, -1.0);
 
-  merge(lower, upper);
-  return upper;
+  merge(lower, out);
 }
 
 template<>
-PointsDeque GrahamScan<PointsDeque>::compute(Points const& points) const {
-  if (points.size() <= 2)
-    return PointsDeque(points.begin(), points.end());
+void GrahamScan<PointsDeque>::compute_into(Points const& points,
+                                           PointsDeque &res,
+                                           Workspace &workspace) const {
+  if (points.size() <= 2) {
+    res.assign(points.begin(), points.end());
+    return;
+  }
 
-  std::vector<Point> pts(points.begin(), points.end());
-  std::sort(pts.begin(), pts.end(), point_cmp);
+  Points &pts = workspace.points(0);
+  pts.assign(points.begin(), points.end());
+  sortPoints(pts);
 
-  PointsDeque res;
+  res.clear();
   res.push_back(pts[0]);
   res.push_back(pts[1]);
   res.push_front(pts[1]);
@@ -116,8 +168,21 @@ PointsDeque GrahamScan<PointsDeque>::compute(Points const& points) const {
 
   res.pop_back();
   std::rotate(res.begin(), res.begin()+lh-1, res.end());
-  return res;
+}
+
+template<>
+PointsDeque GrahamScan<PointsDeque>::compute(Points const& points) const {
+  Workspace workspace;
+  PointsDeque hull;
+  compute_into(points, hull, workspace);
+  return hull;
 }
 
 template Points GrahamScan<Points>::compute(const std::vector<Point> &points) const;
 template PointsList GrahamScan<PointsList>::compute(const std::vector<Point> &points) const;
+template void GrahamScan<Points>::compute_into(const std::vector<Point> &points, Points &out, Workspace &workspace) const;
+template void GrahamScan<PointsList>::compute_into(const std::vector<Point> &points, PointsList &out, Workspace &workspace) const;
+template GridPoints GrahamScan<GridPoints>::compute(const GridPoints &points) const;
+template DoublePoints GrahamScan<DoublePoints>::compute(const DoublePoints &points) const;
+template void GrahamScan<GridPoints>::compute_into(const GridPoints &points, GridPoints &out, Workspace &workspace) const;
+template void GrahamScan<DoublePoints>::compute_into(const DoublePoints &points, DoublePoints &out, Workspace &workspace) const;
@@ -0,0 +1,109 @@
+#include <incremental_hull.hpp>
+#include <iterator>
+#include <util.hpp>
+
+namespace {
+Point vertex(const std::pair<const float, float> &v) {
+  return Point(v.first, v.second);
+}
+} // namespace
+
+IncrementalHull::IncrementalHull(const Points &points) {
+  for (const auto &p : points) {
+    insert(p);
+  }
+}
+
+bool IncrementalHull::insert(const Point &p) {
+  const bool changedUpper = insert(upper, p.x, p.y);
+  const bool changedLower = insert(lower, p.x, -p.y);
+  return changedUpper || changedLower;
+}
+
+bool IncrementalHull::contains(const Point &p) const {
+  return below(upper, p.x, p.y) && below(lower, p.x, -p.y);
+}
+
+void IncrementalHull::clear() {
+  upper.clear();
+  lower.clear();
+}
+
+size_t IncrementalHull::size() const {
+  if (empty()) {
+    return 0;
+  }
+  // the chains share their end points when there is no vertical edge there
+  size_t n = upper.size() + lower.size();
+  n -= upper.begin()->second == -lower.begin()->second;
+  if (n > 1) {
+    n -= upper.rbegin()->second == -lower.rbegin()->second;
+  }
+  return n;
+}
+
+Points IncrementalHull::hull() const {
+  Points hull;
+  hull.reserve(upper.size() + lower.size());
+  for (const auto &v : upper) {
+    hull.push_back(vertex(v));
+  }
+  for (auto it = lower.rbegin(); it != lower.rend(); ++it) {
+    const Point p(it->first, -it->second);
+    // skip the end points shared with the upper chain
+    if (p != hull.back() && p != hull.front()) {
+      hull.push_back(p);
+    }
+  }
+  return hull;
+}
+
+bool IncrementalHull::below(const Chain &chain, float x, float y) {
+  auto next = chain.lower_bound(x);
+  if (next == chain.end()) {
+    return false;
+  }
+  if (next->first == x) {
+    return y <= next->second;
+  }
+  if (next == chain.begin()) {
+    return false;
+  }
+  auto prev = std::prev(next);
+  return !util::isLeft(vertex(*prev), vertex(*next), Point(x, y));
+}
+
+bool IncrementalHull::insert(Chain &chain, float x, float y) {
+  if (below(chain, x, y)) {
+    return false;
+  }
+
+  /* The point is above the chain: it replaces the vertex with the same x, if
+   * any, and hides the neighbours that are no longer strictly above the new
+   * edges */
+  auto it = chain.lower_bound(x);
+  if (it != chain.end() && it->first == x) {
+    it = chain.erase(it);
+  }
+  auto cur = chain.emplace_hint(it, x, y);
+  const Point p(x, y);
+
+  for (auto next = std::next(cur); next != chain.end();) {
+    auto after = std::next(next);
+    if (after == chain.end() ||
+        util::isLeft(p, vertex(*after), vertex(*next))) {
+      break;
+    }
+    next = chain.erase(next);
+  }
+
+  while (cur != chain.begin()) {
+    auto prev = std::prev(cur);
+    if (prev == chain.begin() ||
+        util::isLeft(vertex(*std::prev(prev)), p, vertex(*prev))) {
+      break;
+    }
+    chain.erase(prev);
+  }
+  return true;
+}
@@ -1,150 +1,383 @@
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <marriage_before_conquest.hpp>
+#include <stats.hpp>
+#include <predicates.hpp>
 #include <random>
+#include <thread_pool.hpp>
 #include <util.hpp>
 
 using namespace MarriageNS;
 
-Line MarriageBeforeConquest::findUpperBridge(const Points &points) const {
-  /* Find the upper bridge for the given set of points */
-
-  Point p1, p2;
-  p1 = points[0];
-  Line bridge = {p1, p1};
-  Point maxY = points[0];
-
-  for (size_t i = 1; i < points.size(); ++i) {
-    p2 = points[i];
-    if (p2.y > maxY.y) {
-      maxY = p2;
-    }
-    if (p1.x != p2.x) {
-      if (p1.x < p2.x) {
-        bridge = {p1, p2};
+namespace {
+/* Kirkpatrick-Seidel prune and search: returns the upper bridge of the
+ * candidates over the vertical line x = a, that is the edge (p1, p2) of the
+ * upper hull with p1.x <= a < p2.x. There must be at least one point on each
+ * side of the line. The candidates and `scratch` are used as scratch space.
+ *
+ * Every round pairs up the points and takes the median slope K of the pairs:
+ * the supporting line of slope K tells on which side of the bridge it lies,
+ * and one point of every pair whose slope is on the wrong side of K cannot be
+ * a bridge end point. At least a quarter of the points is discarded per
+ * round, so the bridge is found in O(n) worst case time. The median is
+ * selected on the rounded slopes, but the slopes are compared to it with
+ * exact cross products, so the pruning is always right.
+ */
+Line kirkpatrickSeidelBridge(Points &candidates, float a, Workspace &scratch) {
+  // the pairs, as their left and right points
+  Points &lefts = scratch.points(0);
+  Points &rights = scratch.points(1);
+  Points &next = scratch.points(2);
+  std::vector<double> &slopes = scratch.values(0);
+  std::vector<double> &median = scratch.values(1);
+
+  while (candidates.size() >= 2) {
+    stats::bridge_round();
+    lefts.clear();
+    rights.clear();
+    slopes.clear();
+    next.clear();
+
+    for (size_t i = 0; i + 1 < candidates.size(); i += 2) {
+      Point p = candidates[i];
+      Point q = candidates[i + 1];
+      if (p.x > q.x) {
+        std::swap(p, q);
+      }
+      if (p.x == q.x) {
+        // the lower point of a vertical pair is never on the upper hull
+        next.push_back(p.y > q.y ? p : q);
       } else {
-        bridge = {p2, p1};
+        lefts.push_back(p);
+        rights.push_back(q);
+        slopes.push_back(static_cast<double>(q.y - p.y) / (q.x - p.x));
       }
-      break;
     }
-  }
+    if (candidates.size() % 2 == 1) {
+      next.push_back(candidates.back());
+    }
+    if (lefts.empty()) {
+      candidates.swap(next);
+      continue;
+    }
 
-  if (bridge.p1.x == bridge.p2.x) {
-    // all points have the same x
-    // for upper bridge, take the highest point
-    bridge = {maxY, maxY};
-    return bridge;
-  }
+    median.assign(slopes.begin(), slopes.end());
+    auto mid = median.begin() + median.size() / 2;
+    std::nth_element(median.begin(), mid, median.end());
+    const double K = *mid;
+    const size_t k = std::find(slopes.begin(), slopes.end(), K) - slopes.begin();
+    const Point &m1 = lefts[k];
+    const Point &m2 = rights[k];
+
+    /* Points touched by the supporting line of slope K: the leftmost and the
+     * rightmost one, so that collinear points on the bridge are skipped.
+     * Points are compared with an exact cross product against the median
+     * pair, so that the pair itself always ties. */
+    Point pk = candidates[0], pm = candidates[0];
+    for (const auto &p : candidates) {
+      double side = util::cross(m1, m2, pk, p);
+      if (side > 0) {
+        pk = pm = p;
+      } else if (side == 0) {
+        if (p.x < pk.x) {
+          pk = p;
+        }
+        if (p.x > pm.x) {
+          pm = p;
+        }
+      }
+    }
 
-  float midX = (bridge.p1.x + bridge.p2.x) / 2.0f;
+    if (pk.x <= a && a < pm.x) {
+      return {pk, pm};
+    }
 
-  for (size_t i = 0; i < points.size(); ++i) {
-    const auto &p = points[i];
-    if (util::isLeft(bridge, p)) {
-      /* Point is above the bridge, update the bridge */
-      /* p will be in the new bridge, check if is left or right of midX
-      if p is left then set bridge.p1 = p
-        loop on previous points to check if they're the best option for
-      p2 else set bridge.p2 = p loop on previous points to check if
-      they're the best option for p1
-      */
-      if (p.x < midX) {
-        bridge.p1 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = points[j];
-          if (q.x >= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p2 = q;
-            }
-          }
+    if (pm.x <= a) {
+      /* The bridge is on the right and has slope < K: the left point of a
+       * pair with slope >= K would leave the right one above the bridge */
+      for (size_t i = 0; i < lefts.size(); ++i) {
+        if (util::cross(m1, m2, lefts[i], rights[i]) < 0) {
+          next.push_back(lefts[i]);
         }
-      } else {
-        bridge.p2 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = points[j];
-          if (q.x <= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p1 = q;
-            }
-          }
+        next.push_back(rights[i]);
+      }
+    } else {
+      /* The bridge is on the left and has slope > K */
+      for (size_t i = 0; i < lefts.size(); ++i) {
+        next.push_back(lefts[i]);
+        if (util::cross(m1, m2, lefts[i], rights[i]) > 0) {
+          next.push_back(rights[i]);
         }
       }
     }
+    candidates.swap(next);
   }
 
-  return bridge;
+  // unreachable for consistent predicates: both end points are never pruned
+  return {candidates[0], candidates[0]};
 }
 
-Line MarriageBeforeConquest::findLowerBridge(const Points &points) const {
-  /* Find the lower bridge for the given set of points */
+/* Vertical line splitting the candidates in two non empty halves, as close to
+ * the median x as possible. The median is selected in place, the bridge does
+ * not depend on the order of the candidates. maxX is their largest x, and
+ * they must not all have it. */
+float medianSplit(Points &candidates, float maxX) {
+  auto mid = candidates.begin() + candidates.size() / 2;
+  std::nth_element(candidates.begin(), mid, candidates.end(),
+                   [](const Point &p, const Point &q) { return p.x < q.x; });
+  float a = mid->x;
+  if (a == maxX) {
+    // nothing on the right of the median: use the largest x before it
+    a = -std::numeric_limits<float>::infinity();
+    for (auto p = candidates.begin(); p != mid; ++p) {
+      if (p->x < maxX) {
+        a = std::max(a, p->x);
+      }
+    }
+  }
+  return a;
+}
 
-  Point p1, p2;
-  p1 = points[0];
-  Line bridge = {p1, p1};
-
-  Point minY = points[0];
-  for (size_t i = 1; i < points.size(); ++i) {
-    p2 = points[i];
-    if (p2.y < minY.y) {
-      minY = p2;
+/* Same split line, around the median x of `sample` random candidates:
+ * O(sample) instead of a selection of every x. Small sets, and samples with
+ * nothing on the right of their median, take the exact median. */
+template <typename Rng>
+float sampledSplit(Points &candidates, float maxX, std::vector<double> &xs,
+                   Rng &rng) {
+  constexpr size_t sample = 63;
+  const size_t n = candidates.size();
+  if (n <= 4 * sample) {
+    return medianSplit(candidates, maxX);
+  }
+
+  xs.clear();
+  for (size_t i = 0; i < sample; i++) {
+    xs.push_back(candidates[rng() % n].x);
+  }
+  auto mid = xs.begin() + sample / 2;
+  std::nth_element(xs.begin(), mid, xs.end());
+  const float a = static_cast<float>(*mid);
+  if (a < maxX) {
+    return a;
+  }
+  return medianSplit(candidates, maxX);
+}
+
+/* Drop the candidates strictly on the inner side of the path leftmost ->
+ * extreme -> rightmost, the highest point for the upper bridge and the lowest
+ * one for the lower bridge. The vertices of the path are points of the set,
+ * so these points are not on the upper (lower) hull and cannot be end points
+ * of the bridge. */
+void pruneCandidates(Points &candidates, const Point &leftmost,
+                     const Point &extreme, const Point &rightmost,
+                     bool upper) {
+  auto inner = [&](const Point &p) {
+    if (p.x <= extreme.x) {
+      return upper ? util::isLeft(extreme, leftmost, p)
+                   : util::isLeft(leftmost, extreme, p);
     }
-    if (p1.x != p2.x) {
-      if (p1.x > p2.x) {
-        bridge = {p1, p2};
-      } else {
-        bridge = {p2, p1};
-      }
-      break;
+    return upper ? util::isLeft(rightmost, extreme, p)
+                 : util::isLeft(extreme, rightmost, p);
+  };
+  candidates.erase(
+      std::remove_if(candidates.begin(), candidates.end(), inner),
+      candidates.end());
+}
+
+/* Counter-based generator: the i-th number is the SplitMix64 finalizer of
+ * seed + i * golden ratio, so it has no state to seed but the counter */
+class CounterRng {
+public:
+  using result_type = uint64_t;
+  explicit CounterRng(uint64_t seed) : counter(seed) {}
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~result_type(0); }
+  result_type operator()() {
+    uint64_t z = counter += 0x9e3779b97f4a7c15;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+private:
+  uint64_t counter;
+};
+
+/* Call f with the generator of the policy */
+template <typename F> void withRng(const MBCPolicy &policy, F &&f) {
+  switch (policy.random) {
+  case MBCRandom::Seeded: {
+    std::mt19937_64 rng(policy.seed);
+    f(rng);
+    break;
+  }
+  case MBCRandom::ThreadLocal: {
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    f(rng);
+    break;
+  }
+  case MBCRandom::Counter: {
+    CounterRng rng(policy.seed);
+    f(rng);
+    break;
+  }
+  }
+}
+
+/* Lower bridge of the candidates over x = a, found as the upper bridge of the
+ * points mirrored along the x axis. The bridge goes right to left. */
+Line kirkpatrickSeidelLowerBridge(Points &candidates, float a,
+                                  Workspace &scratch) {
+  for (auto &p : candidates) {
+    p.y = -p.y;
+  }
+  Line bridge = kirkpatrickSeidelBridge(candidates, a, scratch);
+  return {Point(bridge.p2.x, -bridge.p2.y), Point(bridge.p1.x, -bridge.p1.y)};
+}
+
+/* Copy of a set as Points, e.g. for the bridge scratch space */
+void copyPoints(const Points &points, Points &out) {
+  out.assign(points.begin(), points.end());
+}
+void copyPoints(const PointsSoA &points, Points &out) {
+  out.clear();
+  for (const auto &p : points) {
+    out.push_back(p);
+  }
+}
+
+/* Workspace buffer of the same layout as the input set */
+template <typename Set> Set &borrow(Workspace &workspace, size_t i);
+template <> Points &borrow<Points>(Workspace &workspace, size_t i) {
+  return workspace.points(i);
+}
+template <> PointsSoA &borrow<PointsSoA>(Workspace &workspace, size_t i) {
+  return workspace.soa(i);
+}
+
+template <typename Rng>
+void shuffleInto(const Points &points, Points &out, Rng &rng) {
+  out.assign(points.begin(), points.end());
+  std::shuffle(out.begin(), out.end(), rng);
+}
+
+/* Shuffle the indices and gather both coordinate arrays */
+template <typename Rng>
+void shuffleInto(const PointsSoA &points, PointsSoA &out, Rng &rng) {
+  std::vector<size_t> order(points.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), rng);
+
+  out.clear();
+  out.reserve(points.size());
+  for (size_t i : order) {
+    out.push_back(points[i]);
+  }
+}
+} // namespace
+
+/* The sample positions of SampledMedian come from a counter-based generator
+ * keyed by the generator of the policy */
+struct MarriageBeforeConquest::Splitter {
+  MBCSplit split;
+  CounterRng rng;
+
+  /* Splitter of an independent task, keyed by this one */
+  Splitter child() { return Splitter{split, CounterRng(rng())}; }
+
+  float operator()(Points &candidates, float maxX, std::vector<double> &xs) {
+    if (split == MBCSplit::SampledMedian) {
+      return sampledSplit(candidates, maxX, xs, rng);
+    }
+    return medianSplit(candidates, maxX);
+  }
+};
+
+template <typename Set>
+Line MarriageBeforeConquest::findUpperBridge(const Set &points,
+                                             Workspace &workspace,
+                                             Splitter &splitter) const {
+  /* Find the upper bridge for the given set of points */
+
+  /* One pass copies the candidates of the bridge and finds the extremes */
+  Points &candidates = workspace.points(1);
+  candidates.resize(points.size());
+  Point maxY = points[0], leftmost = maxY, rightmost = maxY;
+  for (size_t i = 0; i < points.size(); ++i) {
+    const Point p = points[i];
+    candidates[i] = p;
+    if (p.y > maxY.y) {
+      maxY = p;
+    }
+    if (p.x < leftmost.x) {
+      leftmost = p;
+    } else if (p.x > rightmost.x) {
+      rightmost = p;
     }
   }
-  if (bridge.p1.x == bridge.p2.x) {
+
+  if (leftmost.x == rightmost.x) {
     // all points have the same x
-    // for lower bridge, take the lowest point
-    bridge = {minY, minY};
-    return bridge;
+    // for upper bridge, take the highest point
+    return {maxY, maxY};
   }
 
-  float midX = (bridge.p1.x + bridge.p2.x) / 2.0f;
+  // the split line is the one of the whole set, for the depth of the recursion
+  float a = splitter(candidates, rightmost.x, workspace.values(0));
+  pruneCandidates(candidates, leftmost, maxY, rightmost, true);
+  return kirkpatrickSeidelBridge(candidates, a, workspace.nested(0));
+}
+
+template <typename Set>
+Line MarriageBeforeConquest::findLowerBridge(const Set &points,
+                                             Workspace &workspace,
+                                             Splitter &splitter) const {
+  /* Find the lower bridge for the given set of points */
 
+  /* One pass copies the candidates of the bridge and finds the extremes */
+  Points &candidates = workspace.points(1);
+  candidates.resize(points.size());
+  Point minY = points[0], leftmost = minY, rightmost = minY;
   for (size_t i = 0; i < points.size(); ++i) {
-    const auto &p = points[i];
-    if (util::isLeft(bridge, p)) {
-
-      if (p.x > midX) {
-        bridge.p1 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = points[j];
-          if (q.x <= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p2 = q;
-            }
-          }
-        }
-      } else {
-        bridge.p2 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = points[j];
-          if (q.x >= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p1 = q;
-            }
-          }
-        }
-      }
+    const Point p = points[i];
+    candidates[i] = p;
+    if (p.y < minY.y) {
+      minY = p;
+    }
+    if (p.x < leftmost.x) {
+      leftmost = p;
+    } else if (p.x > rightmost.x) {
+      rightmost = p;
     }
   }
 
-  return bridge;
+  if (leftmost.x == rightmost.x) {
+    // all points have the same x
+    // for lower bridge, take the lowest point
+    return {minY, minY};
+  }
+
+  // the split line is the one of the whole set, for the depth of the recursion
+  float a = splitter(candidates, rightmost.x, workspace.values(0));
+  pruneCandidates(candidates, leftmost, minY, rightmost, false);
+  return kirkpatrickSeidelLowerBridge(candidates, a, workspace.nested(0));
 }
 
-void MarriageBeforeConquest::MBCUpperRecursive(const Points &points,
-                                               Points &hull) const {
+template <typename Set>
+bool MarriageBeforeConquest::upperStep(const Set &points, Points &hull,
+                                       Workspace &workspace,
+                                       Splitter &splitter, Set &leftSet,
+                                       Set &rightSet) const {
   /* If points.size() < 3, add them to the hull */
   if (points.empty()) {
-    return;
+    return false;
   } else if (points.size() == 1) {
     hull.push_back(points[0]);
-    return;
+    return false;
   } else if (points.size() == 2) {
     // add first the leftmost point
     if (points[0].x < points[1].x) {
@@ -161,41 +394,76 @@ void MarriageBeforeConquest::MBCUpperRecursive(const Points &points,
         hull.push_back(points[0]);
       }
     }
-    return;
+    return false;
   }
 
-  Line bridge = findUpperBridge(points);
+  Line bridge = findUpperBridge(points, workspace, splitter);
 
   if (bridge.p1 == bridge.p2) {
     hull.push_back(bridge.p1);
-    return;
+    return false;
   }
 
-  Points leftSet;
-  Points rightSet;
+  Line extremes = util::findExtremePoints(points, true);
+
+  /* Only the points above the segments leftmost -> bridge.p1 and
+   * bridge.p2 -> rightmost can still be on the upper hull */
+  const Point &leftmost = extremes.p1;
+  const Point &rightmost = extremes.p2;
+  leftSet.clear();
+  rightSet.clear();
+  leftSet.push_back(leftmost);
+  rightSet.push_back(bridge.p2);
+  if (bridge.p1 != leftmost) {
+    leftSet.push_back(bridge.p1);
+  }
+  if (bridge.p2 != rightmost) {
+    rightSet.push_back(rightmost);
+  }
 
   for (const auto &p : points) {
-    if (p.x <= bridge.p1.x) {
-      leftSet.push_back(p);
-    } else if (p.x >= bridge.p2.x) {
-      rightSet.push_back(p);
+    if (p.x < bridge.p1.x) {
+      if (util::isLeft(leftmost, bridge.p1, p)) {
+        leftSet.push_back(p);
+      }
+    } else if (p.x > bridge.p2.x) {
+      if (util::isLeft(bridge.p2, rightmost, p)) {
+        rightSet.push_back(p);
+      }
     }
   }
 
-  MBCUpperRecursive(leftSet, hull);
-  MBCUpperRecursive(rightSet, hull);
+  return true;
+}
+
+template <typename Set>
+void MarriageBeforeConquest::MBCUpperRecursive(const Set &points, Points &hull,
+                                               Workspace &workspace,
+                                               Splitter &splitter,
+                                               size_t depth) const {
+  stats::recursion(depth);
+  Set &leftSet = borrow<Set>(workspace, 2 + 2 * depth);
+  Set &rightSet = borrow<Set>(workspace, 3 + 2 * depth);
+  if (upperStep(points, hull, workspace, splitter, leftSet, rightSet)) {
+    stats::discarded(depth, points.size() - leftSet.size() - rightSet.size());
+    MBCUpperRecursive(leftSet, hull, workspace, splitter, depth + 1);
+    MBCUpperRecursive(rightSet, hull, workspace, splitter, depth + 1);
+  }
 }
 
-void MarriageBeforeConquest::MBCLowerRecursive(const Points &points,
-                                               Points &hull) const {
+template <typename Set>
+bool MarriageBeforeConquest::lowerStep(const Set &points, Points &hull,
+                                       Workspace &workspace,
+                                       Splitter &splitter, Set &leftSet,
+                                       Set &rightSet) const {
   /* If points.size() < 3, add them to the hull */
   if (points.empty()) {
-    return;
+    return false;
   } else if (points.size() == 1) {
     if (hull.empty() || hull.back() != points[0]) {
       hull.push_back(points[0]);
     }
-    return;
+    return false;
   } else if (points.size() == 2) {
     // add first the rightmost point
     if (points[0].x > points[1].x) {
@@ -220,58 +488,243 @@ void MarriageBeforeConquest::MBCLowerRecursive(const Points &points,
         }
       }
     }
-    return;
+    return false;
   }
 
-  Line bridge = findLowerBridge(points);
+  Line bridge = findLowerBridge(points, workspace, splitter);
 
   if (bridge.p1 == bridge.p2) {
-    hull.push_back(bridge.p1);
-    return;
+    if (hull.empty() || hull.back() != bridge.p1) {
+      hull.push_back(bridge.p1);
+    }
+    return false;
   }
 
-  Points leftSet;
-  Points rightSet;
+  Line extremes = util::findExtremePoints(points, false);
+
+  /* Only the points below the segments rightmost -> bridge.p1 and
+   * bridge.p2 -> leftmost can still be on the lower hull */
+  const Point &rightmost = extremes.p1;
+  const Point &leftmost = extremes.p2;
+  leftSet.clear();
+  rightSet.clear();
+  leftSet.push_back(leftmost);
+  rightSet.push_back(bridge.p1);
+  if (bridge.p2 != leftmost) {
+    leftSet.push_back(bridge.p2);
+  }
+  if (bridge.p1 != rightmost) {
+    rightSet.push_back(rightmost);
+  }
 
   for (const auto &p : points) {
-    if (p.x <= bridge.p2.x) {
-      leftSet.push_back(p);
-    } else if (p.x >= bridge.p1.x) {
-      rightSet.push_back(p);
+    if (p.x < bridge.p2.x) {
+      if (util::isLeft(bridge.p2, leftmost, p)) {
+        leftSet.push_back(p);
+      }
+    } else if (p.x > bridge.p1.x) {
+      if (util::isLeft(rightmost, bridge.p1, p)) {
+        rightSet.push_back(p);
+      }
     }
   }
 
-  MBCLowerRecursive(rightSet, hull);
-  MBCLowerRecursive(leftSet, hull);
+  return true;
 }
 
-Points MarriageBeforeConquest::compute(const Points &points) const {
+template <typename Set>
+void MarriageBeforeConquest::MBCLowerRecursive(const Set &points, Points &hull,
+                                               Workspace &workspace,
+                                               Splitter &splitter,
+                                               size_t depth) const {
+  stats::recursion(depth);
+  Set &leftSet = borrow<Set>(workspace, 2 + 2 * depth);
+  Set &rightSet = borrow<Set>(workspace, 3 + 2 * depth);
+  if (lowerStep(points, hull, workspace, splitter, leftSet, rightSet)) {
+    stats::discarded(depth, points.size() - leftSet.size() - rightSet.size());
+    MBCLowerRecursive(rightSet, hull, workspace, splitter, depth + 1);
+    MBCLowerRecursive(leftSet, hull, workspace, splitter, depth + 1);
+  }
+}
+
+template <typename Set>
+MarriageBeforeConquest::Splitter
+MarriageBeforeConquest::prepare(const Set &points, const Set *&input,
+                                Workspace &workspace) const {
+  uint64_t key = 0;
+  withRng(policy, [&](auto &rng) {
+    if (policy.split == MBCSplit::Shuffle) {
+      Set &shuffledPoints = borrow<Set>(workspace, 0);
+      shuffleInto(points, shuffledPoints, rng);
+      input = &shuffledPoints;
+    }
+    key = rng();
+  });
+  return Splitter{policy.split, CounterRng(key)};
+}
 
+template <typename Set>
+void MarriageBeforeConquest::computeHull(const Set &points, Points &hull,
+                                         Workspace &workspace) const {
+  hull.clear();
   if (points.size() <= 2) {
-    return points;
+    copyPoints(points, hull);
+    return;
   }
 
-  Points hull = Points();
+  const Set *input = &points;
+  Splitter splitter = prepare(points, input, workspace);
 
-  std::random_device rd;
-  std::mt19937 rng(rd());
-  
-  std::vector<Point> shuffledPoints = points;
-  std::shuffle(shuffledPoints.begin(), shuffledPoints.end(), rng);
+  MBCUpperRecursive(*input, hull, workspace, splitter, 0);
 
-  MBCUpperRecursive(shuffledPoints, hull);
+  MBCLowerRecursive(*input, hull, workspace, splitter, 0);
+  if (hull.size() > 1 && hull.front() == hull.back()) {
+    hull.pop_back(); // remove last point to avoid duplication of leftmost point
+  }
+}
 
-  MBCLowerRecursive(shuffledPoints, hull);
-  if (hull.front() == hull.back()) {
+Points MarriageBeforeConquest::compute(const Points &points) const {
+  Workspace workspace;
+  Points hull;
+  computeHull(points, hull, workspace);
+  return hull;
+}
+
+Points MarriageBeforeConquest::compute(const PointsSoA &points) const {
+  Workspace workspace;
+  Points hull;
+  computeHull(points, hull, workspace);
+  return hull;
+}
+
+void MarriageBeforeConquest::compute_into(const Points &points, Points &hull,
+                                          Workspace &workspace) const {
+  computeHull(points, hull, workspace);
+}
+
+// ParallelMarriageBeforeConquest Implementation
+
+namespace {
+/* Append the part of the hull built by a task, as the serial recursion would
+ * have appended it. The upper leaves push every point, but the lower ones do
+ * not push a point that is already the last one of the hull, which a task
+ * cannot see: the first point of a lower part is dropped here instead (the
+ * next ones were checked against the part itself, whose last point is the
+ * same). */
+void splice(Points &hull, const Points &part, bool lower) {
+  auto first = part.begin();
+  if (lower && first != part.end() && !hull.empty() && hull.back() == *first) {
+    ++first;
+  }
+  hull.insert(hull.end(), first, part.end());
+}
+} // namespace
+
+ParallelMarriageBeforeConquest::ParallelMarriageBeforeConquest(
+    unsigned threads, size_t cutoff, MBCPolicy policy)
+    : MarriageBeforeConquest(policy), threads(threads),
+      cutoff(std::max<size_t>(cutoff, 1)) {}
+
+Points ParallelMarriageBeforeConquest::compute(const Points &points) const {
+  if (threads <= 1 || points.size() <= 2) {
+    return MarriageBeforeConquest::compute(points);
+  }
+
+  Workspace workspace;
+  const Points *input = &points;
+  Splitter upperSplitter = prepare(points, input, workspace);
+  Splitter lowerSplitter = upperSplitter.child();
+
+  /* The two halves only append to their own hull, run them concurrently */
+  Points hull, lowerHull;
+  {
+    TaskGroup group(ThreadPool::shared(threads));
+    group.run([&] { upperParallel(*input, hull, upperSplitter); });
+    lowerParallel(*input, lowerHull, lowerSplitter);
+    group.wait();
+  }
+
+  splice(hull, lowerHull, true);
+  if (hull.size() > 1 && hull.front() == hull.back()) {
     hull.pop_back(); // remove last point to avoid duplication of leftmost point
   }
   return hull;
 }
 
+Points ParallelMarriageBeforeConquest::compute(const PointsSoA &points) const {
+  return compute(points.to_aos());
+}
+
+Points ParallelMarriageBeforeConquest::compute(const PointsView &points) const {
+  return compute(points.to_aos());
+}
+
+void ParallelMarriageBeforeConquest::compute_into(const Points &points,
+                                                  Points &hull,
+                                                  Workspace &workspace) const {
+  (void)workspace;
+  hull = compute(points);
+}
+
+void ParallelMarriageBeforeConquest::upperParallel(const Points &points,
+                                                   Points &hull,
+                                                   Splitter &splitter) const {
+  /* Small subproblems are not worth a task */
+  Workspace workspace;
+  if (points.size() <= cutoff) {
+    MBCUpperRecursive(points, hull, workspace, splitter, 0);
+    return;
+  }
+
+  Points leftSet, rightSet;
+  if (!upperStep(points, hull, workspace, splitter, leftSet, rightSet)) {
+    return;
+  }
+
+  /* The left part is stolen by another worker while we compute the right
+   * one, then they are spliced in the serial order: left, right */
+  Points leftHull, rightHull;
+  Splitter leftSplitter = splitter.child();
+  TaskGroup group(ThreadPool::shared(threads));
+  group.run([&] { upperParallel(leftSet, leftHull, leftSplitter); });
+  upperParallel(rightSet, rightHull, splitter);
+  group.wait();
+
+  splice(hull, leftHull, false);
+  splice(hull, rightHull, false);
+}
+
+void ParallelMarriageBeforeConquest::lowerParallel(const Points &points,
+                                                   Points &hull,
+                                                   Splitter &splitter) const {
+  Workspace workspace;
+  if (points.size() <= cutoff) {
+    MBCLowerRecursive(points, hull, workspace, splitter, 0);
+    return;
+  }
+
+  Points leftSet, rightSet;
+  if (!lowerStep(points, hull, workspace, splitter, leftSet, rightSet)) {
+    return;
+  }
+
+  // the lower hull goes right to left
+  Points leftHull, rightHull;
+  Splitter leftSplitter = splitter.child();
+  TaskGroup group(ThreadPool::shared(threads));
+  group.run([&] { lowerParallel(leftSet, leftHull, leftSplitter); });
+  lowerParallel(rightSet, rightHull, splitter);
+  group.wait();
+
+  splice(hull, rightHull, true);
+  splice(hull, leftHull, true);
+}
+
 // MarriageBeforeConquestV2 Implementation
 
 Line MarriageBeforeConquestV2::findUpperBridge(const Points &points,
-                                               const Line &extremes) const {
+                                               const Line &extremes,
+                                               Workspace &workspace) const {
   /* Find the upper bridge for the given set of points */
 
   Point p1, p2;
@@ -289,46 +742,24 @@ Line MarriageBeforeConquestV2::findUpperBridge(const Points &points,
     return util::isLeft(extremes, p) || p == extremes.p1 || p == extremes.p2;
   };
 
-  Points prunedPoints;
+  Points &prunedPoints = workspace.points(1);
+  prunedPoints.clear();
 
   // Use std::copy_if to copy values that satisfy the condition into
   // prunedPoints
   std::copy_if(points.begin(), points.end(), std::back_inserter(prunedPoints),
                condition);
 
-  for (size_t i = 0; i < prunedPoints.size(); ++i) {
-    const auto &p = prunedPoints[i];
-    if (util::isLeft(bridge, p)) {
-      /* Point is above the bridge and above the extremes, update the bridge */
-      if (p.x < midX) {
-        bridge.p1 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = prunedPoints[j];
-          if (q.x >= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p2 = q;
-            }
-          }
-        }
-      } else {
-        bridge.p2 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = prunedPoints[j];
-          if (q.x <= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p1 = q;
-            }
-          }
-        }
-      }
-    }
+  // the bridge must have points on both sides of the split line
+  if (!(midX < p2.x)) {
+    midX = p1.x;
   }
-
-  return bridge;
+  return kirkpatrickSeidelBridge(prunedPoints, midX, workspace.nested(0));
 }
 
 Line MarriageBeforeConquestV2::findLowerBridge(const Points &points,
-                                               const Line &extremes) const {
+                                               const Line &extremes,
+                                               Workspace &workspace) const {
   /* Find the lower bridge for the given set of points */
 
   Point p1, p2;
@@ -346,46 +777,27 @@ Line MarriageBeforeConquestV2::findLowerBridge(const Points &points,
     return util::isLeft(extremes, p) || p == extremes.p1 || p == extremes.p2;
   };
 
-  Points prunedPoints;
+  Points &prunedPoints = workspace.points(1);
+  prunedPoints.clear();
 
   // Use std::copy_if to copy values that satisfy the condition into
   // prunedPoints
   std::copy_if(points.begin(), points.end(), std::back_inserter(prunedPoints),
                condition);
 
-  for (size_t i = 0; i < prunedPoints.size(); ++i) {
-    const auto &p = prunedPoints[i];
-    if (util::isLeft(extremes, p) && util::isLeft(bridge, p)) {
-      /* Point is under the bridge and under the extremes, update the bridge */
-      if (p.x > midX) {
-        bridge.p1 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = prunedPoints[j];
-          if (q.x <= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p2 = q;
-            }
-          }
-        }
-      } else {
-        bridge.p2 = p;
-        for (size_t j = 0; j < i; ++j) {
-          const auto &q = prunedPoints[j];
-          if (q.x >= midX) {
-            if (util::isLeft(bridge, q)) {
-              bridge.p1 = q;
-            }
-          }
-        }
-      }
-    }
+  // the bridge must have points on both sides of the split line
+  if (!(midX < p1.x)) {
+    midX = p2.x;
   }
-
-  return bridge;
+  return kirkpatrickSeidelLowerBridge(prunedPoints, midX,
+                                      workspace.nested(0));
 }
 
 void MarriageBeforeConquestV2::MBCUpperRecursive(const Points &points,
-                                                 Points &hull) const {
+                                                 Points &hull,
+                                                 Workspace &workspace,
+                                                 size_t depth) const {
+  stats::recursion(depth);
   /* If points.size() < 3, add them to the hull */
   if (points.empty()) {
     return;
@@ -413,30 +825,50 @@ void MarriageBeforeConquestV2::MBCUpperRecursive(const Points &points,
 
   Line extremes = util::findExtremePoints(points, true);
 
-  Line bridge = findUpperBridge(points, extremes);
+  Line bridge = findUpperBridge(points, extremes, workspace);
 
   if (bridge.p1 == bridge.p2) {
     hull.push_back(bridge.p1);
     return;
   }
 
-  Points leftSet;
-  Points rightSet;
+  /* Only the points above the segments leftmost -> bridge.p1 and
+   * bridge.p2 -> rightmost can still be on the upper hull */
+  const Point &leftmost = extremes.p1;
+  const Point &rightmost = extremes.p2;
+  Points &leftSet = workspace.points(2 + 2 * depth);
+  Points &rightSet = workspace.points(3 + 2 * depth);
+  leftSet.assign(1, leftmost);
+  rightSet.assign(1, bridge.p2);
+  if (bridge.p1 != leftmost) {
+    leftSet.push_back(bridge.p1);
+  }
+  if (bridge.p2 != rightmost) {
+    rightSet.push_back(rightmost);
+  }
 
   for (const auto &p : points) {
-    if (p.x <= bridge.p1.x) {
-      leftSet.push_back(p);
-    } else if (p.x >= bridge.p2.x) {
-      rightSet.push_back(p);
+    if (p.x < bridge.p1.x) {
+      if (util::isLeft(leftmost, bridge.p1, p)) {
+        leftSet.push_back(p);
+      }
+    } else if (p.x > bridge.p2.x) {
+      if (util::isLeft(bridge.p2, rightmost, p)) {
+        rightSet.push_back(p);
+      }
     }
   }
 
-  MBCUpperRecursive(leftSet, hull);
-  MBCUpperRecursive(rightSet, hull);
+  stats::discarded(depth, points.size() - leftSet.size() - rightSet.size());
+  MBCUpperRecursive(leftSet, hull, workspace, depth + 1);
+  MBCUpperRecursive(rightSet, hull, workspace, depth + 1);
 }
 
 void MarriageBeforeConquestV2::MBCLowerRecursive(const Points &points,
-                                                 Points &hull) const {
+                                                 Points &hull,
+                                                 Workspace &workspace,
+                                                 size_t depth) const {
+  stats::recursion(depth);
   /* If points.size() < 3, add them to the hull */
   if (points.empty()) {
     return;
@@ -474,47 +906,73 @@ void MarriageBeforeConquestV2::MBCLowerRecursive(const Points &points,
 
   Line extremes = util::findExtremePoints(points, false);
 
-  Line bridge = findLowerBridge(points, extremes);
+  Line bridge = findLowerBridge(points, extremes, workspace);
 
   if (bridge.p1 == bridge.p2) {
     hull.push_back(bridge.p1);
     return;
   }
 
-  Points leftSet;
-  Points rightSet;
+  /* Only the points below the segments rightmost -> bridge.p1 and
+   * bridge.p2 -> leftmost can still be on the lower hull */
+  const Point &rightmost = extremes.p1;
+  const Point &leftmost = extremes.p2;
+  Points &leftSet = workspace.points(2 + 2 * depth);
+  Points &rightSet = workspace.points(3 + 2 * depth);
+  leftSet.assign(1, leftmost);
+  rightSet.assign(1, bridge.p1);
+  if (bridge.p2 != leftmost) {
+    leftSet.push_back(bridge.p2);
+  }
+  if (bridge.p1 != rightmost) {
+    rightSet.push_back(rightmost);
+  }
 
   for (const auto &p : points) {
-    if (p.x <= bridge.p2.x) {
-      leftSet.push_back(p);
-    } else if (p.x >= bridge.p1.x) {
-      rightSet.push_back(p);
+    if (p.x < bridge.p2.x) {
+      if (util::isLeft(bridge.p2, leftmost, p)) {
+        leftSet.push_back(p);
+      }
+    } else if (p.x > bridge.p1.x) {
+      if (util::isLeft(rightmost, bridge.p1, p)) {
+        rightSet.push_back(p);
+      }
     }
   }
 
-  MBCLowerRecursive(rightSet, hull);
-  MBCLowerRecursive(leftSet, hull);
+  stats::discarded(depth, points.size() - leftSet.size() - rightSet.size());
+  MBCLowerRecursive(rightSet, hull, workspace, depth + 1);
+  MBCLowerRecursive(leftSet, hull, workspace, depth + 1);
 }
 
 Points MarriageBeforeConquestV2::compute(const Points &points) const {
+  Workspace workspace;
+  Points hull;
+  compute_into(points, hull, workspace);
+  return hull;
+}
 
+void MarriageBeforeConquestV2::compute_into(const Points &points, Points &hull,
+                                            Workspace &workspace) const {
+  hull.clear();
   if (points.size() <= 2) {
-    return points;
+    hull.assign(points.begin(), points.end());
+    return;
   }
 
-  Points hull = Points();
-
-  std::random_device rd;
-  std::mt19937 rng(rd());
-
-  std::vector<Point> shuffledPoints = points;
-  std::shuffle(shuffledPoints.begin(), shuffledPoints.end(), rng);
+  const Points *input = &points;
+  if (policy.split == MBCSplit::Shuffle) {
+    withRng(policy, [&](auto &rng) {
+      Points &shuffledPoints = workspace.points(0);
+      shuffleInto(points, shuffledPoints, rng);
+      input = &shuffledPoints;
+    });
+  }
 
-  MBCUpperRecursive(shuffledPoints, hull);
+  MBCUpperRecursive(*input, hull, workspace, 0);
 
-  MBCLowerRecursive(shuffledPoints, hull);
+  MBCLowerRecursive(*input, hull, workspace, 0);
   if (hull.front() == hull.back()) {
     hull.pop_back(); // remove last point to avoid duplication of leftmost point
   }
-  return hull;
 }
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <point_file.hpp>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <util.hpp>
+
+namespace util {
+namespace {
+constexpr char magic[8] = "HULLPTS";
+} // namespace
+
+void write_point_file(const std::string &filename, const Points &points) {
+  PointFileHeader header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = point_file_version;
+  header.count = points.size();
+
+  bool sorted = true;
+  if (!points.empty()) {
+    header.minX = header.maxX = points[0].x;
+    header.minY = header.maxY = points[0].y;
+  }
+  for (size_t i = 0; i < points.size(); ++i) {
+    const Point &p = points[i];
+    header.minX = std::min(header.minX, p.x);
+    header.minY = std::min(header.minY, p.y);
+    header.maxX = std::max(header.maxX, p.x);
+    header.maxY = std::max(header.maxY, p.y);
+    sorted = sorted && (i == 0 || sort_key(points[i - 1]) <= sort_key(p));
+  }
+  if (sorted) {
+    header.flags |= PointFileSorted;
+  }
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot open file: " + filename);
+  }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(points.data()),
+             points.size() * sizeof(Point));
+  if (!file) {
+    throw std::runtime_error("Cannot write file: " + filename);
+  }
+}
+
+MappedPoints::MappedPoints(const std::string &filename) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open file: " + filename);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(PointFileHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Not a point file: " + filename);
+  }
+  length = st.st_size;
+  mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // the mapping keeps the file alive
+  if (mapping == MAP_FAILED) {
+    mapping = nullptr;
+    throw std::runtime_error("Cannot map file: " + filename);
+  }
+
+  const PointFileHeader &h = header();
+  std::string error;
+  if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) {
+    error = "Not a point file: ";
+  } else if (h.version != point_file_version) {
+    error = "Unsupported point file version " + std::to_string(h.version) +
+            ": ";
+  } else if (h.count != (length - sizeof(PointFileHeader)) / sizeof(Point) ||
+             (length - sizeof(PointFileHeader)) % sizeof(Point) != 0) {
+    error = "Truncated point file: ";
+  }
+  if (!error.empty()) {
+    ::munmap(mapping, length);
+    mapping = nullptr;
+    throw std::runtime_error(error + filename);
+  }
+}
+
+MappedPoints::MappedPoints(MappedPoints &&other) noexcept
+    : mapping(other.mapping), length(other.length) {
+  other.mapping = nullptr;
+  other.length = 0;
+}
+
+MappedPoints &MappedPoints::operator=(MappedPoints &&other) noexcept {
+  std::swap(mapping, other.mapping);
+  std::swap(length, other.length);
+  return *this;
+}
+
+MappedPoints::~MappedPoints() {
+  if (mapping) {
+    ::munmap(mapping, length);
+  }
+}
+
+const PointFileHeader &MappedPoints::header() const {
+  return *static_cast<const PointFileHeader *>(mapping);
+}
+
+PointsView MappedPoints::points() const {
+  const char *base = static_cast<const char *>(mapping);
+  return PointsView(
+      reinterpret_cast<const Point *>(base + sizeof(PointFileHeader)),
+      header().count);
+}
+
+bool is_point_file(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  char start[sizeof(magic)] = {};
+  file.read(start, sizeof(start));
+  return file && std::memcmp(start, magic, sizeof(magic)) == 0;
+}
+
+} // namespace util
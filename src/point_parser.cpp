@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <thread_pool.hpp>
+#include <util.hpp>
+
+namespace util {
+namespace {
+// bytes read from the file at a time
+constexpr size_t block_size = 1 << 22;
+// smallest chunk given to a thread
+constexpr size_t min_chunk = 1 << 20;
+
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+const char *skip_spaces(const char *p, const char *end) {
+  while (p != end && is_space(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+const char *line_end(const char *p, const char *end) {
+  const void *nl = std::memchr(p, '\n', end - p);
+  return nl ? static_cast<const char *>(nl) : end;
+}
+
+bool blank(const char *first, const char *last) {
+  return skip_spaces(first, last) == last;
+}
+
+/* Number as written by the stream operators: from_chars does not take a
+ * leading '+'. Returns nullptr if there is no number at p. */
+template <typename T> const char *parse_number(const char *p, const char *end,
+                                               T &value) {
+  if (p != end && *p == '+') {
+    ++p;
+  }
+  auto [next, ec] = std::from_chars(p, end, value);
+  return ec == std::errc() ? next : nullptr;
+}
+
+/* "x y" on a non blank line. Returns the reason on error, nullptr otherwise */
+const char *parse_point(const char *first, const char *last, Point &point) {
+  const char *p = skip_spaces(first, last);
+  p = parse_number(p, last, point.x);
+  if (!p) {
+    return "invalid x coordinate";
+  }
+  const char *q = skip_spaces(p, last);
+  if (q == p && q != last) {
+    return "expected a space after the x coordinate";
+  }
+  q = parse_number(q, last, point.y);
+  if (!q) {
+    return "invalid y coordinate";
+  }
+  if (!blank(q, last)) {
+    return "unexpected characters after the y coordinate";
+  }
+  return nullptr;
+}
+
+struct Chunk {
+  const char *first;
+  const char *last;
+  size_t line;   // number of the first line
+  size_t lines;  // newlines in the chunk
+  size_t count;  // points in the chunk
+  size_t offset; // index of its first point
+  // first error of the chunk, if any
+  size_t errorLine = 0;
+  const char *error = nullptr;
+};
+
+void count_points(Chunk &chunk) {
+  chunk.lines = 0;
+  chunk.count = 0;
+  for (const char *p = chunk.first; p != chunk.last;) {
+    const char *eol = line_end(p, chunk.last);
+    if (!blank(p, eol)) {
+      ++chunk.count;
+    }
+    if (eol == chunk.last) {
+      break;
+    }
+    ++chunk.lines;
+    p = eol + 1;
+  }
+}
+
+void parse_chunk(Chunk &chunk, Point *out) {
+  size_t line = chunk.line;
+  for (const char *p = chunk.first; p != chunk.last; ++line) {
+    const char *eol = line_end(p, chunk.last);
+    if (!blank(p, eol)) {
+      if (const char *error = parse_point(p, eol, *out)) {
+        chunk.error = error;
+        chunk.errorLine = line;
+        return;
+      }
+      ++out;
+    }
+    if (eol == chunk.last) {
+      break;
+    }
+    p = eol + 1;
+  }
+}
+
+[[noreturn]] void fail(const std::string &name, size_t line,
+                       const std::string &reason) {
+  throw std::runtime_error(name + ":" + std::to_string(line) + ": " + reason);
+}
+
+/* Run f(chunk) for every chunk, on the shared pool if threads > 1 */
+template <typename F>
+void for_each_chunk(std::vector<Chunk> &chunks, unsigned threads, F f) {
+  if (threads <= 1 || chunks.size() == 1) {
+    for (auto &chunk : chunks) {
+      f(chunk);
+    }
+    return;
+  }
+  TaskGroup group(ThreadPool::shared(threads));
+  for (auto &chunk : chunks) {
+    group.run([&f, &chunk] { f(chunk); });
+  }
+  group.wait();
+}
+} // namespace
+
+void parse_points(const char *first, const char *last, Points &points,
+                  unsigned threads, const std::string &name) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  /* 1. The header: the first non blank line holds the number of points */
+  size_t line = 1;
+  const char *p = first;
+  while (p != last && blank(p, line_end(p, last))) {
+    p = line_end(p, last);
+    p += p != last;
+    ++line;
+  }
+  if (p == last) {
+    fail(name, line, "missing number of points");
+  }
+  const char *eol = line_end(p, last);
+  unsigned long long n = 0;
+  const char *q = parse_number(skip_spaces(p, eol), eol, n);
+  if (!q || !blank(q, eol)) {
+    fail(name, line, "invalid number of points");
+  }
+  const size_t headerLine = line;
+  const char *body = eol == last ? last : eol + 1;
+  ++line;
+
+  /* 2. Split the rest at line boundaries and count the points per chunk */
+  const size_t size = last - body;
+  const size_t parts =
+      std::max<size_t>(1, std::min<size_t>(threads, size / min_chunk));
+  std::vector<Chunk> chunks;
+  const char *start = body;
+  for (size_t i = 1; i <= parts && start != last; ++i) {
+    const char *end = i == parts ? last : body + size * i / parts;
+    if (end < start) {
+      end = start;
+    }
+    end = line_end(end, last);
+    end += end != last; // the newline belongs to this chunk
+    chunks.push_back({start, end, 0, 0, 0, 0});
+    start = end;
+  }
+  for_each_chunk(chunks, threads, count_points);
+
+  size_t total = 0;
+  for (auto &chunk : chunks) {
+    chunk.line = line;
+    chunk.offset = total;
+    line += chunk.lines;
+    total += chunk.count;
+  }
+  // before the allocation, which a wrong header could make huge
+  if (total != n) {
+    fail(name, headerLine,
+         "expected " + std::to_string(n) + " points, found " +
+             std::to_string(total));
+  }
+
+  /* 3. Parse every chunk into its own slot */
+  points.resize(n);
+  Point *out = points.data();
+  for_each_chunk(chunks, threads,
+                 [out](Chunk &chunk) { parse_chunk(chunk, out + chunk.offset); });
+
+  for (const auto &chunk : chunks) {
+    if (chunk.error) {
+      fail(name, chunk.errorLine, chunk.error);
+    }
+  }
+}
+
+void parse_points_file(const std::string &filename, Points &points,
+                       unsigned threads) {
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot open file: " + filename);
+  }
+  const size_t size = static_cast<size_t>(file.tellg());
+  file.seekg(0);
+
+  // not value-initialized: every byte is overwritten by the reads
+  std::unique_ptr<char[]> text(new char[size]);
+  for (size_t read = 0; read < size;) {
+    const size_t block = std::min(block_size, size - read);
+    if (!file.read(text.get() + read, block)) {
+      throw std::runtime_error("Cannot read file: " + filename);
+    }
+    read += block;
+  }
+
+  parse_points(text.get(), text.get() + size, points, threads, filename);
+}
+
+} // namespace util
@@ -0,0 +1,81 @@
+#include <cmath>
+#include <predicates.hpp>
+
+namespace {
+/* a + b = sum + error exactly (Knuth's two-sum) */
+inline void two_sum(double a, double b, double &sum, double &error) {
+  sum = a + b;
+  const double bv = sum - a;
+  const double av = sum - bv;
+  error = (a - av) + (b - bv);
+}
+
+/* Add b to the expansion e (nonoverlapping components of increasing
+ * magnitude, whose sum is exact) in place, dropping zero components;
+ * returns the new length */
+size_t grow_expansion(double *e, size_t length, double b) {
+  size_t h = 0;
+  double q = b;
+  for (size_t i = 0; i < length; i++) {
+    double error;
+    two_sum(q, e[i], q, error);
+    if (error != 0) {
+      e[h++] = error;
+    }
+  }
+  if (q != 0 || h == 0) {
+    e[h++] = q;
+  }
+  return h;
+}
+
+/* a * b = product + error exactly; std::fma rounds only once */
+inline void two_product(double a, double b, double &product, double &error) {
+  product = a * b;
+  error = std::fma(a, b, -product);
+}
+
+/* Sum of the terms as an expansion into e, which has room for all of them;
+ * returns its largest component */
+template <size_t N>
+double sum_exactly(const double (&terms)[N], double (&e)[N]) {
+  size_t length = 0;
+  for (double term : terms) {
+    length = grow_expansion(e, length, term);
+  }
+  // the largest component has the sign of the sum and is within an ulp of it
+  return e[length - 1];
+}
+} // namespace
+
+namespace util {
+double exact_cross(const Point &a, const Point &b, const Point &c,
+                   const Point &d) {
+  /* (b - a) x (d - c) expanded into products of two coordinates, which are
+   * exact in double: 24 bit significands give at most 48 bits */
+  const double terms[] = {
+      double(b.x) * d.y,  -double(b.x) * c.y, -double(a.x) * d.y,
+      double(a.x) * c.y,  -double(b.y) * d.x, double(b.y) * c.x,
+      double(a.y) * d.x,  -double(a.y) * c.x,
+  };
+
+  double e[8];
+  return sum_exactly(terms, e);
+}
+
+double exact_cross(const DoublePoint &a, const DoublePoint &b,
+                   const DoublePoint &c, const DoublePoint &d) {
+  // the same products, each one as the sum of its rounding and its error
+  const double factors[][2] = {
+      {b.x, d.y},  {-b.x, c.y}, {-a.x, d.y}, {a.x, c.y},
+      {-b.y, d.x}, {b.y, c.x},  {a.y, d.x},  {-a.y, c.x},
+  };
+  double terms[16];
+  for (size_t i = 0; i < 8; i++) {
+    two_product(factors[i][0], factors[i][1], terms[2 * i], terms[2 * i + 1]);
+  }
+
+  double e[16];
+  return sum_exactly(terms, e);
+}
+} // namespace util
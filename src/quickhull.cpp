@@ -1,19 +1,74 @@
+#include <algorithm>
+#include <predicates.hpp>
 #include <quickhull.hpp>
+#include <simd.hpp>
+#include <stats.hpp>
+#include <thread_pool.hpp>
 #include <util.hpp>
 
 /* Convex Hull Factory */
 using namespace QuickHullNS;
 
+namespace {
+/* simd::farthest compares rounded distances, so it can miss a point that is
+ * farther from (p1, p2) than q by less than the rounding error. Such a point
+ * is outside the triangle (p1, q, p2), that is in one of the sets of the
+ * partition: q is moved to it, comparing the distances exactly. Returns
+ * whether q moved, and the partition must then be done again. */
+template <typename Set>
+bool farthestExactly(const Point &p1, const Point &p2, const Set &set,
+                     Point &q) {
+  bool moved = false;
+  for (const auto &p : set) {
+    if (util::cross(p1, p2, q, p) > 0) {
+      q = p;
+      moved = true;
+    }
+  }
+  return moved;
+}
+
+/* The point farthestExactly starts from: the one of simd::farthest, or the
+ * first one when it returns n. Far from the origin, the rounded distances of
+ * points that are exactly left of (p1, p2) can all be below -1. */
+template <typename Set> Point farthestStart(const Set &set, size_t index) {
+  return set[index < set.size() ? index : 0];
+}
+} // namespace
+
 
 Points QuickHull::compute(const Points &points) const {
+  Workspace workspace;
+  Points hull = Points();
+  compute_into(points, hull, workspace);
+  return hull;
+}
+
+void QuickHull::compute_into(const Points &points, Points &hull,
+                             Workspace &workspace) const {
+  computeFrom(points, hull, workspace);
+}
+
+Points QuickHull::compute(const PointsView &points) const {
+  Workspace workspace;
+  Points hull = Points();
+  computeFrom(points, hull, workspace);
+  return hull;
+}
+
+template <typename Input>
+void QuickHull::computeFrom(const Input &points, Points &hull,
+                            Workspace &workspace) const {
   /* ·
    * To initialize, find the point q1 with the smallest x-coordinate and the
    * point q2 with the largest x- coordinate, and form the line segment s by
    * connecting them. Then prune all the points below s. · QuickHull(q1 q2 , P )
    */
-  Points upper_points = Points();
-  Points lower_points = Points();
-  Points hull = Points();
+  Points &upper_points = workspace.points(0);
+  Points &lower_points = workspace.points(1);
+  upper_points.clear();
+  lower_points.clear();
+  hull.clear();
 
   Point q1upper, q2upper;
   Point q1lower, q2lower;
@@ -49,7 +104,8 @@ Points QuickHull::compute(const Points &points) const {
   }
 
   /* Recursively find the upper and lower hulls */
-  QuickHull::findHullRecursive(q1upper, q2upper, upper_points, hull);
+  QuickHull::findHullRecursive(q1upper, q2upper, upper_points, hull, workspace,
+                               1);
 
   // conclude the cycle of the upper hull with the last point of the upper hull
   // if needed another check to avoid duplicates
@@ -60,18 +116,25 @@ Points QuickHull::compute(const Points &points) const {
   if (hull.empty() || !(hull.back() == q2lower))
     hull.push_back(q2lower);
 
-  QuickHull::findHullRecursive(q2lower, q1lower, lower_points, hull);
+  QuickHull::findHullRecursive(q2lower, q1lower, lower_points, hull, workspace,
+                               1);
 
   // conclude the cycle of the bottom hull with the last point of the bottom
   // hull if needed
   if (hull.empty() || !(hull.back() == q1lower || hull.front() == q1lower))
     hull.push_back(q1lower);
-
-  return hull;
 }
 
 void QuickHull::findHullRecursive(const Point &p1, const Point &p2,
                                   const Points &points, Points &hull) const {
+  Workspace workspace;
+  findHullRecursive(p1, p2, points, hull, workspace, 0);
+}
+
+void QuickHull::findHullRecursive(const Point &p1, const Point &p2,
+                                  const Points &points, Points &hull,
+                                  Workspace &workspace, size_t depth) const {
+  stats::recursion(depth);
   /* No more points left */
   if (points.empty()) {
     return;
@@ -82,34 +145,378 @@ void QuickHull::findHullRecursive(const Point &p1, const Point &p2,
   }
 
   /* 1. Find the point q on one side of s that has the largest distance to s. */
-  double maxDistance = -1.0;
-  Point q;
-  for (const auto &p : points) {
-    double distance = util::partial_distance(Line(p1, p2), p);
-    if (distance > maxDistance) {
-      maxDistance = distance;
-      q = p;
-    }
-  }
+  Point q = farthestStart(
+      points, simd::farthest(points.data(), points.size(), p1, p2));
 
   /* 2. Add q to the convex hull */
   // NOTE: This is done after the recursive calls to maintain the correct order
 
   /* 3. Partition the remaining points into two subsets Pℓ and Pr */
+  // the sets of this depth: deeper calls borrow other buffers
+  Points &leftSet = workspace.points(2 * depth);
+  Points &rightSet = workspace.points(2 * depth + 1);
+  do {
+    leftSet.clear();
+    rightSet.clear();
+    for (const auto &p : points) {
+      if (util::isLeft(p1, q, p)) {
+        leftSet.push_back(p);
+      } else if (util::isLeft(q, p2, p)) {
+        rightSet.push_back(p);
+      }
+    }
+  } while (farthestExactly(p1, p2, leftSet, q) ||
+           farthestExactly(p1, p2, rightSet, q));
+  stats::discarded(depth, points.size() - leftSet.size() - rightSet.size());
+
+  /* 4. Recurse on the two subsets */
+  // if bottom hull i recurr on the right side first
+
+    findHullRecursive(p1, q, leftSet, hull, workspace, depth + 1);
+    hull.push_back(q);
+    findHullRecursive(q, p2, rightSet, hull, workspace, depth + 1);
+}
+
+// Structure of arrays QuickHull
+
+Points QuickHull::compute(const PointsSoA &points) const {
+  Points hull = Points();
+  if (points.empty()) {
+    return hull;
+  }
+
+  Point q1upper, q2upper;
+  Point q1lower, q2lower;
+
+  auto [q1, q2] = util::findExtremePointsCases(points);
+  if (q1.first.y == q1.second.y) {
+    q1upper = q1lower = q1.first;
+  } else {
+    q1upper = q1.second;
+    q1lower = q1.first;
+  }
+
+  if (q2.first.x == q2.second.x) {
+    q2upper = q2lower = q2.first;
+  } else {
+    q2upper = q2.second;
+    q2lower = q2.first;
+  }
+
+  PointsSoA upper_points, lower_points;
+  const float *xs = points.xs();
+  const float *ys = points.ys();
+  for (size_t i = 0; i < points.size(); ++i) {
+    const Point p(xs[i], ys[i]);
+    if (util::isLeft(q1upper, q2upper, p)) {
+      upper_points.push_back(p);
+    }
+    if (util::isLeft(q2lower, q1lower, p)) {
+      lower_points.push_back(p);
+    }
+  }
+
+  hull.push_back(q1upper);
+
+  findHullRecursive(q1upper, q2upper, upper_points, hull);
+
+  if (!(hull.back() == q2upper))
+    hull.push_back(q2upper);
+
+  if (!(hull.back() == q2lower))
+    hull.push_back(q2lower);
+
+  findHullRecursive(q2lower, q1lower, lower_points, hull);
+
+  if (!(hull.back() == q1lower || hull.front() == q1lower))
+    hull.push_back(q1lower);
+
+  return hull;
+}
+
+void QuickHull::findHullRecursive(const Point &p1, const Point &p2,
+                                  const PointsSoA &points, Points &hull) const {
+  if (points.empty()) {
+    return;
+  }
+  if (points.size() == 1) {
+    hull.push_back(points[0]);
+    return;
+  }
+
+  const float *xs = points.xs();
+  const float *ys = points.ys();
+  Point q =
+      farthestStart(points, simd::farthest(xs, ys, points.size(), p1, p2));
+
+  PointsSoA leftSet, rightSet;
+  do {
+    leftSet.clear();
+    rightSet.clear();
+    for (size_t i = 0; i < points.size(); ++i) {
+      const Point p(xs[i], ys[i]);
+      if (util::isLeft(p1, q, p)) {
+        leftSet.push_back(p);
+      } else if (util::isLeft(q, p2, p)) {
+        rightSet.push_back(p);
+      }
+    }
+  } while (farthestExactly(p1, p2, leftSet, q) ||
+           farthestExactly(p1, p2, rightSet, q));
+
+  findHullRecursive(p1, q, leftSet, hull);
+  hull.push_back(q);
+  findHullRecursive(q, p2, rightSet, hull);
+}
+
+// ParallelQuickHull Implementation
+
+ParallelQuickHull::ParallelQuickHull(unsigned threads, size_t cutoff)
+    : threads(threads), cutoff(std::max<size_t>(cutoff, 1)) {}
+
+Points ParallelQuickHull::compute(const Points &points) const {
+  if (threads <= 1) {
+    return QuickHull::compute(points);
+  }
+
+  Points upper_points = Points();
+  Points lower_points = Points();
+  Points hull = Points();
+
+  Point q1upper, q2upper;
+  Point q1lower, q2lower;
+
+  auto [q1, q2] = util::findExtremePointsCases(points);
+  if (q1.first.y == q1.second.y) {
+    q1upper = q1lower = q1.first;
+  } else {
+    q1upper = q1.second;
+    q1lower = q1.first;
+  }
+
+  if (q2.first.x == q2.second.x) {
+    q2upper = q2lower = q2.first;
+  } else {
+    q2upper = q2.second;
+    q2lower = q2.first;
+  }
+
+  for (const auto &p : points) {
+    if (util::isLeft(q1upper, q2upper, p)) {
+      upper_points.push_back(p);
+    }
+    if (util::isLeft(q2lower, q1lower, p)) {
+      lower_points.push_back(p);
+    }
+  }
+
+  /* The two halves only append to their own hull, run them concurrently */
+  Points upper_hull, lower_hull;
+  {
+    TaskGroup group(ThreadPool::shared(threads));
+    group.run([&] {
+      findHullParallel(q1upper, q2upper, upper_points, upper_hull);
+    });
+    findHullParallel(q2lower, q1lower, lower_points, lower_hull);
+    group.wait();
+  }
+
+  /* Stitch the halves together exactly as the serial version does */
+  hull.push_back(q1upper);
+  hull.insert(hull.end(), upper_hull.begin(), upper_hull.end());
+
+  if (!(hull.back() == q2upper))
+    hull.push_back(q2upper);
+
+  if (!(hull.back() == q2lower))
+    hull.push_back(q2lower);
+
+  hull.insert(hull.end(), lower_hull.begin(), lower_hull.end());
+
+  if (!(hull.back() == q1lower || hull.front() == q1lower))
+    hull.push_back(q1lower);
+
+  return hull;
+}
+
+Points ParallelQuickHull::compute(const PointsSoA &points) const {
+  return compute(points.to_aos());
+}
+
+Points ParallelQuickHull::compute(const PointsView &points) const {
+  return compute(points.to_aos());
+}
+
+void ParallelQuickHull::compute_into(const Points &points, Points &hull,
+                                     Workspace &workspace) const {
+  if (threads <= 1) {
+    QuickHull::compute_into(points, hull, workspace);
+    return;
+  }
+  hull = compute(points);
+}
+
+void ParallelQuickHull::findHullParallel(const Point &p1, const Point &p2,
+                                         const Points &points,
+                                         Points &hull) const {
+  /* Small subproblems are not worth a task */
+  if (points.size() <= cutoff) {
+    findHullRecursive(p1, p2, points, hull);
+    return;
+  }
+
+  Point q = farthestStart(
+      points, simd::farthest(points.data(), points.size(), p1, p2));
+
   Points leftSet = Points();
   Points rightSet = Points();
-  for (const auto &p : points) {
+  do {
+    leftSet.clear();
+    rightSet.clear();
+    for (const auto &p : points) {
+      if (util::isLeft(p1, q, p)) {
+        leftSet.push_back(p);
+      } else if (util::isLeft(q, p2, p)) {
+        rightSet.push_back(p);
+      }
+    }
+  } while (farthestExactly(p1, p2, leftSet, q) ||
+           farthestExactly(p1, p2, rightSet, q));
+
+  /* The left hull is stolen by another worker while we compute the right one,
+   * then they are concatenated in the serial order: left, q, right */
+  Points leftHull, rightHull;
+  TaskGroup group(ThreadPool::shared(threads));
+  group.run([&] { findHullParallel(p1, q, leftSet, leftHull); });
+  findHullParallel(q, p2, rightSet, rightHull);
+  group.wait();
+
+  hull.insert(hull.end(), leftHull.begin(), leftHull.end());
+  hull.push_back(q);
+  hull.insert(hull.end(), rightHull.begin(), rightHull.end());
+}
+
+// InPlaceQuickHull Implementation
+
+Points InPlaceQuickHull::compute(const Points &points) const {
+  Workspace workspace;
+  Points hull = Points();
+  compute_into(points, hull, workspace);
+  return hull;
+}
+
+void InPlaceQuickHull::compute_into(const Points &points, Points &hull,
+                                    Workspace &workspace) const {
+  hull.clear();
+  if (points.empty()) {
+    return;
+  }
+
+  Point q1upper, q2upper;
+  Point q1lower, q2lower;
+
+  auto [q1, q2] = util::findExtremePointsCases(points);
+  if (q1.first.y == q1.second.y) {
+    q1upper = q1lower = q1.first;
+  } else {
+    q1upper = q1.second;
+    q1lower = q1.first;
+  }
+
+  if (q2.first.x == q2.second.x) {
+    q2upper = q2lower = q2.first;
+  } else {
+    q2upper = q2.second;
+    q2lower = q2.first;
+  }
+
+  /* The only copy of the input: from now on we partition this buffer */
+  Points &scratch = workspace.points(0);
+  scratch.assign(points.begin(), points.end());
+
+  /* Move the upper points to the front and the lower points right after them,
+   * keeping track of the farthest point of each set */
+  Point *first = scratch.data();
+  Point *last = first + scratch.size();
+  Point *u = first, *l = first;
+  Point qUpper, qLower;
+  for (Point *it = first; it != last; ++it) {
+    Point p = *it;
+    // distances are compared exactly, as differences of cross products
+    if (util::isLeft(q1upper, q2upper, p)) {
+      if (u == first || util::cross(q1upper, q2upper, qUpper, p) > 0) {
+        qUpper = p;
+      }
+      *it = *l;
+      *l = *u;
+      *u = p;
+      ++u;
+      ++l;
+    } else if (util::isLeft(q2lower, q1lower, p)) {
+      if (l == u || util::cross(q2lower, q1lower, qLower, p) > 0) {
+        qLower = p;
+      }
+      *it = *l;
+      *l = p;
+      ++l;
+    }
+  }
+
+  hull.push_back(q1upper);
+
+  findHullInPlace(q1upper, q2upper, qUpper, first, u, hull);
+
+  if (!(hull.back() == q2upper))
+    hull.push_back(q2upper);
+
+  if (!(hull.back() == q2lower))
+    hull.push_back(q2lower);
+
+  findHullInPlace(q2lower, q1lower, qLower, u, l, hull);
+
+  if (!(hull.back() == q1lower || hull.front() == q1lower))
+    hull.push_back(q1lower);
+}
+
+void InPlaceQuickHull::findHullInPlace(const Point &p1, const Point &p2,
+                                       const Point &q, Point *first,
+                                       Point *last, Points &hull) const {
+  /* [first, last) holds the points left of (p1, p2), q is the farthest one */
+  if (first == last) {
+    return;
+  }
+  if (last - first == 1) {
+    hull.push_back(*first);
+    return;
+  }
+
+  /* Single pass: [first, l) ends up left of (p1, q), [l, r) left of (q, p2),
+   * everything else is inside the triangle (p1, q, p2) and is dropped. The
+   * farthest point of both halves is computed along the way. */
+  Point *l = first, *r = first;
+  Point qLeft, qRight;
+  for (Point *it = first; it != last; ++it) {
+    Point p = *it;
     if (util::isLeft(p1, q, p)) {
-      leftSet.push_back(p);
+      if (l == first || util::cross(p1, q, qLeft, p) > 0) {
+        qLeft = p;
+      }
+      *it = *r;
+      *r = *l;
+      *l = p;
+      ++l;
+      ++r;
     } else if (util::isLeft(q, p2, p)) {
-      rightSet.push_back(p);
+      if (r == l || util::cross(q, p2, qRight, p) > 0) {
+        qRight = p;
+      }
+      *it = *r;
+      *r = p;
+      ++r;
     }
   }
 
-  /* 4. Recurse on the two subsets */
-  // if bottom hull i recurr on the right side first
-
-    findHullRecursive(p1, q, leftSet, hull);
-    hull.push_back(q);
-    findHullRecursive(q, p2, rightSet, hull);
+  findHullInPlace(p1, q, qLeft, first, l, hull);
+  hull.push_back(q);
+  findHullInPlace(q, p2, qRight, l, r, hull);
 }
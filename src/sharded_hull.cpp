@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <predicates.hpp>
+#include <sharded_hull.hpp>
+#include <thread>
+#include <thread_pool.hpp>
+
+namespace {
+/* point_cmp and the turn test of Graham Scan, inlined for nth_element and
+ * the chains (see batch_hull.cpp) */
+inline bool before(const Point &a, const Point &b) {
+  return a.x != b.x ? a.x < b.x : a.y > b.y;
+}
+
+inline bool turns(double side, const Point &a, const Point &b, const Point &c) {
+  return util::orientation(a, c, b) * side <= 0;
+}
+
+/* Upper and lower chains of a hull, both from its first to its last point in
+ * point_cmp order */
+struct Chains {
+  Points upper, lower;
+};
+
+/* Extend a chain with sorted points that all come after it. On a convex
+ * chain nothing is popped until the tangent from the first new point, so
+ * merging two x-separated chains is linear. */
+void extend(Points &half, const Point *first, const Point *last, double side) {
+  for (; first != last; ++first) {
+    while (half.size() >= 2 &&
+           turns(side, half[half.size() - 2], half.back(), *first)) {
+      half.pop_back();
+    }
+    half.push_back(*first);
+  }
+}
+
+/* The chains of a local hull, whatever vertex and orientation the inner
+ * algorithm starts from: the few vertices are sorted first */
+void split(Points &hull, Chains &chains) {
+  std::sort(hull.begin(), hull.end(), before);
+  const Point *first = hull.data(), *last = hull.data() + hull.size();
+  chains.upper.clear();
+  chains.lower.clear();
+  extend(chains.upper, first, last, 1.0);
+  extend(chains.lower, first, last, -1.0);
+}
+
+/* Merge the chains of the next shard into `left` */
+void join(Chains &left, const Chains &right) {
+  const Points &upper = right.upper, &lower = right.lower;
+  extend(left.upper, upper.data(), upper.data() + upper.size(), 1.0);
+  extend(left.lower, lower.data(), lower.data() + lower.size(), -1.0);
+}
+
+/* The hull in the order of Graham Scan: the upper chain, then the lower one
+ * backwards without its end points */
+Points assemble(const Chains &chains) {
+  Points hull = chains.upper;
+  for (size_t i = chains.lower.size() - 1; i-- > 1;) {
+    hull.push_back(chains.lower[i]);
+  }
+  return hull;
+}
+
+/* Partition the points so that shard i, [bounds[i], bounds[i + 1]), comes
+ * before shard i + 1 in point_cmp order. The halves are split concurrently. */
+void partition(ThreadPool &pool, Point *points,
+               const std::vector<size_t> &bounds, size_t lo, size_t hi) {
+  if (hi - lo <= 1) {
+    return;
+  }
+  const size_t mid = (lo + hi) / 2;
+  std::nth_element(points + bounds[lo], points + bounds[mid],
+                   points + bounds[hi], before);
+
+  TaskGroup group(pool);
+  group.run([&] { partition(pool, points, bounds, lo, mid); });
+  partition(pool, points, bounds, mid, hi);
+  group.wait();
+}
+
+/* Bounds of `shards` shards of n points of about the same size */
+std::vector<size_t> shardBounds(size_t n, size_t shards) {
+  std::vector<size_t> bounds(shards + 1);
+  for (size_t i = 0; i <= shards; i++) {
+    bounds[i] = i * n / shards;
+  }
+  return bounds;
+}
+} // namespace
+
+ShardedHull::ShardedHull(std::shared_ptr<const ConvexHull<Points>> inner,
+                         unsigned threads, ShardMerge merge, size_t cutoff)
+    : inner(std::move(inner)),
+      threads(threads == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                           : threads),
+      merge(merge), cutoff(cutoff) {}
+
+Points ShardedHull::compute(const Points &points) const {
+  // every shard gets at least three points
+  if (threads <= 1 || points.size() <= cutoff || points.size() < 6) {
+    return inner->compute(points);
+  }
+  return merge == ShardMerge::Tangents ? tangents(points) : unite(points);
+}
+
+void ShardedHull::compute_into(const Points &points, Points &hull,
+                               Workspace &workspace) const {
+  (void)workspace;
+  hull = compute(points);
+}
+
+Points ShardedHull::tangents(const Points &points) const {
+  const size_t shards = std::min<size_t>(threads, points.size() / 3);
+  const std::vector<size_t> bounds = shardBounds(points.size(), shards);
+  ThreadPool &pool = ThreadPool::shared(threads);
+
+  Points sorted(points);
+  partition(pool, sorted.data(), bounds, 0, shards);
+
+  std::vector<Chains> chains(shards);
+  {
+    TaskGroup group(pool);
+    for (size_t i = 0; i < shards; i++) {
+      group.run([&, i] {
+        Points local = inner->compute(
+            PointsView(sorted.data() + bounds[i], bounds[i + 1] - bounds[i]));
+        split(local, chains[i]);
+      });
+    }
+    group.wait();
+  }
+
+  // pairwise tree: after the level of `step`, chains[i] holds 2 * step shards
+  for (size_t step = 1; step < shards; step *= 2) {
+    TaskGroup group(pool);
+    for (size_t i = 0; i + step < shards; i += 2 * step) {
+      group.run([&, i, step] { join(chains[i], chains[i + step]); });
+    }
+    group.wait();
+  }
+  return assemble(chains[0]);
+}
+
+Points ShardedHull::unite(const Points &points) const {
+  const size_t shards = std::min<size_t>(threads, points.size() / 3);
+  const std::vector<size_t> bounds = shardBounds(points.size(), shards);
+
+  std::vector<Points> hulls(shards);
+  {
+    TaskGroup group(ThreadPool::shared(threads));
+    for (size_t i = 0; i < shards; i++) {
+      group.run([&, i] {
+        hulls[i] = inner->compute(
+            PointsView(points.data() + bounds[i], bounds[i + 1] - bounds[i]));
+      });
+    }
+    group.wait();
+  }
+
+  Points vertices;
+  for (const auto &hull : hulls) {
+    vertices.insert(vertices.end(), hull.begin(), hull.end());
+  }
+  return inner->compute(vertices);
+}
@@ -0,0 +1,447 @@
+#include <simd.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(Point) == 2 * sizeof(float),
+              "The kernels read Point arrays as interleaved floats");
+
+namespace simd {
+namespace {
+
+/* ---- Input layouts ----
+ *
+ * The kernels are written once and instantiated for both layouts: `at` reads
+ * a single point, `load4`/`load8` read the x and y coordinates of 4/8
+ * consecutive points into separate registers. */
+
+/* Array of structures: interleaved x, y */
+struct AoS {
+  const Point *points;
+
+  Point at(size_t i) const { return points[i]; }
+
+#ifdef SIMD_X86
+  __attribute__((target("sse4.1"))) void load4(size_t i, __m128 &x,
+                                               __m128 &y) const {
+    const float *f = reinterpret_cast<const float *>(points + i);
+    __m128 a = _mm_loadu_ps(f);
+    __m128 b = _mm_loadu_ps(f + 4);
+    x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+  }
+
+  // the shuffle permutes the points across lanes, x and y stay paired
+  __attribute__((target("avx2"))) void load8(size_t i, __m256 &x,
+                                             __m256 &y) const {
+    const float *f = reinterpret_cast<const float *>(points + i);
+    __m256 a = _mm256_loadu_ps(f);
+    __m256 b = _mm256_loadu_ps(f + 8);
+    x = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+  }
+#endif
+};
+
+/* Structure of arrays: plain loads, no shuffle */
+struct SoA {
+  const float *xs;
+  const float *ys;
+
+  Point at(size_t i) const { return Point(xs[i], ys[i]); }
+
+#ifdef SIMD_X86
+  __attribute__((target("sse4.1"))) void load4(size_t i, __m128 &x,
+                                               __m128 &y) const {
+    x = _mm_loadu_ps(xs + i);
+    y = _mm_loadu_ps(ys + i);
+  }
+
+  __attribute__((target("avx2"))) void load8(size_t i, __m256 &x,
+                                             __m256 &y) const {
+    x = _mm256_loadu_ps(xs + i);
+    y = _mm256_loadu_ps(ys + i);
+  }
+#endif
+};
+
+/* ---- Scalar ---- */
+
+/* Fold point (x, y) into the running extremes, same rules as
+ * util::findExtremePointsCases */
+inline void foldLeft(float x, float yMin, float yMax, Extremes &e) {
+  if (x < e.leftYMin.x) {
+    e.leftYMin = Point(x, yMin);
+    e.leftYMax = Point(x, yMax);
+  } else if (x == e.leftYMin.x) {
+    if (yMin < e.leftYMin.y) {
+      e.leftYMin = Point(x, yMin);
+    }
+    if (yMax > e.leftYMax.y) {
+      e.leftYMax = Point(x, yMax);
+    }
+  }
+}
+
+inline void foldRight(float x, float yMin, float yMax, Extremes &e) {
+  if (x > e.rightYMax.x) {
+    e.rightYMin = Point(x, yMin);
+    e.rightYMax = Point(x, yMax);
+  } else if (x == e.rightYMax.x) {
+    if (yMin < e.rightYMin.y) {
+      e.rightYMin = Point(x, yMin);
+    }
+    if (yMax > e.rightYMax.y) {
+      e.rightYMax = Point(x, yMax);
+    }
+  }
+}
+
+template <typename Input>
+void extremesTail(const Input &in, size_t begin, size_t n, Extremes &e) {
+  for (size_t i = begin; i < n; ++i) {
+    const Point p = in.at(i);
+    foldLeft(p.x, p.y, p.y, e);
+    foldRight(p.x, p.y, p.y, e);
+  }
+}
+
+template <typename Input> Extremes extremesScalar(const Input &in, size_t n) {
+  const Point p0 = in.at(0);
+  Extremes e{p0, p0, p0, p0};
+  extremesTail(in, 0, n, e);
+  return e;
+}
+
+/* util::sidedness without its exact fallback (float differences, double
+ * products): only the largest distance is needed, not exact signs */
+inline double distance(const Point &p, const Point &p1, const Point &p2) {
+  const double dx_32 = p.x - p2.x;
+  const double dy_12 = p1.y - p2.y;
+  const double dy_32 = p.y - p2.y;
+  const double dx_12 = p1.x - p2.x;
+  return (dx_32 * dy_12) - (dy_32 * dx_12);
+}
+
+template <typename Input>
+size_t farthestTail(const Input &in, size_t begin, size_t n, const Point &p1,
+                    const Point &p2, double &best, size_t index) {
+  for (size_t i = begin; i < n; ++i) {
+    double d = distance(in.at(i), p1, p2);
+    if (d > best) {
+      best = d;
+      index = i;
+    }
+  }
+  return index;
+}
+
+template <typename Input>
+size_t farthestScalar(const Input &in, size_t n, const Point &p1,
+                      const Point &p2) {
+  double best = -1.0;
+  return farthestTail(in, 0, n, p1, p2, best, n);
+}
+
+#ifdef SIMD_X86
+
+/* Reduce per-lane argmax candidates: largest value, smallest index on ties */
+inline void reduceArgmax(const double *values, const double *indices,
+                         size_t lanes, double &best, size_t &index) {
+  for (size_t j = 0; j < lanes; ++j) {
+    size_t i = static_cast<size_t>(indices[j]);
+    if (values[j] > best || (values[j] == best && i < index)) {
+      best = values[j];
+      index = i;
+    }
+  }
+}
+
+/* ---- SSE4.1 ---- */
+
+template <typename Input>
+__attribute__((target("sse4.1"))) Extremes extremesSSE4(const Input &in,
+                                                         size_t n) {
+  const Point p0 = in.at(0);
+  __m128 lx = _mm_set1_ps(p0.x), rx = lx;
+  __m128 lyMin = _mm_set1_ps(p0.y), lyMax = lyMin;
+  __m128 ryMin = lyMin, ryMax = lyMin;
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 x, y;
+    in.load4(i, x, y);
+
+    __m128 lt = _mm_cmplt_ps(x, lx);
+    __m128 leq = _mm_cmpeq_ps(x, lx);
+    lyMin = _mm_blendv_ps(_mm_blendv_ps(lyMin, _mm_min_ps(lyMin, y), leq), y,
+                          lt);
+    lyMax = _mm_blendv_ps(_mm_blendv_ps(lyMax, _mm_max_ps(lyMax, y), leq), y,
+                          lt);
+    lx = _mm_blendv_ps(lx, x, lt);
+
+    __m128 gt = _mm_cmpgt_ps(x, rx);
+    __m128 req = _mm_cmpeq_ps(x, rx);
+    ryMin = _mm_blendv_ps(_mm_blendv_ps(ryMin, _mm_min_ps(ryMin, y), req), y,
+                          gt);
+    ryMax = _mm_blendv_ps(_mm_blendv_ps(ryMax, _mm_max_ps(ryMax, y), req), y,
+                          gt);
+    rx = _mm_blendv_ps(rx, x, gt);
+  }
+
+  alignas(16) float v[6][4];
+  _mm_store_ps(v[0], lx);
+  _mm_store_ps(v[1], lyMin);
+  _mm_store_ps(v[2], lyMax);
+  _mm_store_ps(v[3], rx);
+  _mm_store_ps(v[4], ryMin);
+  _mm_store_ps(v[5], ryMax);
+
+  Extremes e{p0, p0, p0, p0};
+  for (size_t j = 0; j < 4; ++j) {
+    foldLeft(v[0][j], v[1][j], v[2][j], e);
+    foldRight(v[3][j], v[4][j], v[5][j], e);
+  }
+  extremesTail(in, i, n, e);
+  return e;
+}
+
+template <typename Input>
+__attribute__((target("sse4.1"))) size_t
+farthestSSE4(const Input &in, size_t n, const Point &p1, const Point &p2) {
+  const __m128 p2x = _mm_set1_ps(p2.x), p2y = _mm_set1_ps(p2.y);
+  const __m128d dy12 = _mm_set1_pd(static_cast<float>(p1.y - p2.y));
+  const __m128d dx12 = _mm_set1_pd(static_cast<float>(p1.x - p2.x));
+
+  // lanes (i, i + 1) and (i + 2, i + 3)
+  __m128d bestLo = _mm_set1_pd(-1.0), bestHi = bestLo;
+  __m128d idxLo = _mm_set1_pd(static_cast<double>(n)), idxHi = idxLo;
+  __m128d curLo = _mm_set_pd(1.0, 0.0), curHi = _mm_set_pd(3.0, 2.0);
+  const __m128d four = _mm_set1_pd(4.0);
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 x, y;
+    in.load4(i, x, y);
+    __m128 dx32 = _mm_sub_ps(x, p2x);
+    __m128 dy32 = _mm_sub_ps(y, p2y);
+
+    __m128d dLo = _mm_sub_pd(_mm_mul_pd(_mm_cvtps_pd(dx32), dy12),
+                             _mm_mul_pd(_mm_cvtps_pd(dy32), dx12));
+    __m128d dHi =
+        _mm_sub_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(dx32, dx32)), dy12),
+                   _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(dy32, dy32)), dx12));
+
+    __m128d gtLo = _mm_cmpgt_pd(dLo, bestLo);
+    __m128d gtHi = _mm_cmpgt_pd(dHi, bestHi);
+    bestLo = _mm_blendv_pd(bestLo, dLo, gtLo);
+    bestHi = _mm_blendv_pd(bestHi, dHi, gtHi);
+    idxLo = _mm_blendv_pd(idxLo, curLo, gtLo);
+    idxHi = _mm_blendv_pd(idxHi, curHi, gtHi);
+    curLo = _mm_add_pd(curLo, four);
+    curHi = _mm_add_pd(curHi, four);
+  }
+
+  alignas(16) double values[4], indices[4];
+  _mm_store_pd(values, bestLo);
+  _mm_store_pd(values + 2, bestHi);
+  _mm_store_pd(indices, idxLo);
+  _mm_store_pd(indices + 2, idxHi);
+
+  double best = -1.0;
+  size_t index = n;
+  reduceArgmax(values, indices, 4, best, index);
+  return farthestTail(in, i, n, p1, p2, best, index);
+}
+
+/* ---- AVX2 ---- */
+
+template <typename Input>
+__attribute__((target("avx2"))) Extremes extremesAVX2(const Input &in,
+                                                       size_t n) {
+  const Point p0 = in.at(0);
+  __m256 lx = _mm256_set1_ps(p0.x), rx = lx;
+  __m256 lyMin = _mm256_set1_ps(p0.y), lyMax = lyMin;
+  __m256 ryMin = lyMin, ryMax = lyMin;
+
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 x, y;
+    in.load8(i, x, y);
+
+    __m256 lt = _mm256_cmp_ps(x, lx, _CMP_LT_OQ);
+    __m256 leq = _mm256_cmp_ps(x, lx, _CMP_EQ_OQ);
+    lyMin = _mm256_blendv_ps(
+        _mm256_blendv_ps(lyMin, _mm256_min_ps(lyMin, y), leq), y, lt);
+    lyMax = _mm256_blendv_ps(
+        _mm256_blendv_ps(lyMax, _mm256_max_ps(lyMax, y), leq), y, lt);
+    lx = _mm256_blendv_ps(lx, x, lt);
+
+    __m256 gt = _mm256_cmp_ps(x, rx, _CMP_GT_OQ);
+    __m256 req = _mm256_cmp_ps(x, rx, _CMP_EQ_OQ);
+    ryMin = _mm256_blendv_ps(
+        _mm256_blendv_ps(ryMin, _mm256_min_ps(ryMin, y), req), y, gt);
+    ryMax = _mm256_blendv_ps(
+        _mm256_blendv_ps(ryMax, _mm256_max_ps(ryMax, y), req), y, gt);
+    rx = _mm256_blendv_ps(rx, x, gt);
+  }
+
+  alignas(32) float v[6][8];
+  _mm256_store_ps(v[0], lx);
+  _mm256_store_ps(v[1], lyMin);
+  _mm256_store_ps(v[2], lyMax);
+  _mm256_store_ps(v[3], rx);
+  _mm256_store_ps(v[4], ryMin);
+  _mm256_store_ps(v[5], ryMax);
+
+  Extremes e{p0, p0, p0, p0};
+  for (size_t j = 0; j < 8; ++j) {
+    foldLeft(v[0][j], v[1][j], v[2][j], e);
+    foldRight(v[3][j], v[4][j], v[5][j], e);
+  }
+  extremesTail(in, i, n, e);
+  return e;
+}
+
+/* Distances of the four points starting at i */
+template <typename Input>
+__attribute__((target("avx2"))) inline __m256d
+distances4(const Input &in, size_t i, __m128 p2x, __m128 p2y, __m256d dy12,
+           __m256d dx12) {
+  __m128 x, y;
+  in.load4(i, x, y);
+  __m128 dx32 = _mm_sub_ps(x, p2x);
+  __m128 dy32 = _mm_sub_ps(y, p2y);
+  return _mm256_sub_pd(_mm256_mul_pd(_mm256_cvtps_pd(dx32), dy12),
+                       _mm256_mul_pd(_mm256_cvtps_pd(dy32), dx12));
+}
+
+template <typename Input>
+__attribute__((target("avx2"))) size_t
+farthestAVX2(const Input &in, size_t n, const Point &p1, const Point &p2) {
+  const __m128 p2x = _mm_set1_ps(p2.x), p2y = _mm_set1_ps(p2.y);
+  const __m256d dy12 = _mm256_set1_pd(static_cast<float>(p1.y - p2.y));
+  const __m256d dx12 = _mm256_set1_pd(static_cast<float>(p1.x - p2.x));
+
+  // two independent accumulators, for points (i .. i + 3) and (i + 4 .. i + 7)
+  __m256d bestA = _mm256_set1_pd(-1.0), bestB = bestA;
+  __m256d idxA = _mm256_set1_pd(static_cast<double>(n)), idxB = idxA;
+  __m256d curA = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+  __m256d curB = _mm256_set_pd(7.0, 6.0, 5.0, 4.0);
+  const __m256d eight = _mm256_set1_pd(8.0);
+
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256d dA = distances4(in, i, p2x, p2y, dy12, dx12);
+    __m256d dB = distances4(in, i + 4, p2x, p2y, dy12, dx12);
+
+    __m256d gtA = _mm256_cmp_pd(dA, bestA, _CMP_GT_OQ);
+    __m256d gtB = _mm256_cmp_pd(dB, bestB, _CMP_GT_OQ);
+    bestA = _mm256_blendv_pd(bestA, dA, gtA);
+    bestB = _mm256_blendv_pd(bestB, dB, gtB);
+    idxA = _mm256_blendv_pd(idxA, curA, gtA);
+    idxB = _mm256_blendv_pd(idxB, curB, gtB);
+    curA = _mm256_add_pd(curA, eight);
+    curB = _mm256_add_pd(curB, eight);
+  }
+
+  alignas(32) double values[8], indices[8];
+  _mm256_store_pd(values, bestA);
+  _mm256_store_pd(values + 4, bestB);
+  _mm256_store_pd(indices, idxA);
+  _mm256_store_pd(indices + 4, idxB);
+
+  double bestValue = -1.0;
+  size_t index = n;
+  reduceArgmax(values, indices, 8, bestValue, index);
+  return farthestTail(in, i, n, p1, p2, bestValue, index);
+}
+
+#endif // SIMD_X86
+
+Level detect() {
+#ifdef SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return Level::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return Level::SSE4;
+  }
+#endif
+  return Level::Scalar;
+}
+
+const Level detected = detect();
+Level current = detected;
+
+template <typename Input> Extremes dispatchExtremes(const Input &in, size_t n) {
+  switch (current) {
+#ifdef SIMD_X86
+  case Level::AVX2:
+    return extremesAVX2(in, n);
+  case Level::SSE4:
+    return extremesSSE4(in, n);
+#endif
+  default:
+    return extremesScalar(in, n);
+  }
+}
+
+template <typename Input>
+size_t dispatchFarthest(const Input &in, size_t n, const Point &p1,
+                        const Point &p2) {
+  switch (current) {
+#ifdef SIMD_X86
+  case Level::AVX2:
+    return farthestAVX2(in, n, p1, p2);
+  case Level::SSE4:
+    return farthestSSE4(in, n, p1, p2);
+#endif
+  default:
+    return farthestScalar(in, n, p1, p2);
+  }
+}
+
+} // namespace
+
+Level detected_level() { return detected; }
+
+Level level() { return current; }
+
+void set_level(Level l) {
+  current = static_cast<int>(l) <= static_cast<int>(detected) ? l : detected;
+}
+
+const char *level_name(Level l) {
+  switch (l) {
+  case Level::AVX2:
+    return "avx2";
+  case Level::SSE4:
+    return "sse4";
+  default:
+    return "scalar";
+  }
+}
+
+Extremes extremes(const Point *points, size_t n) {
+  return dispatchExtremes(AoS{points}, n);
+}
+
+Extremes extremes(const float *xs, const float *ys, size_t n) {
+  return dispatchExtremes(SoA{xs, ys}, n);
+}
+
+size_t farthest(const Point *points, size_t n, const Point &p1,
+                const Point &p2) {
+  return dispatchFarthest(AoS{points}, n, p1, p2);
+}
+
+size_t farthest(const float *xs, const float *ys, size_t n, const Point &p1,
+                const Point &p2) {
+  return dispatchFarthest(SoA{xs, ys}, n, p1, p2);
+}
+
+} // namespace simd
@@ -0,0 +1,28 @@
+#include <sliding_window_hull.hpp>
+
+void SlidingWindowHull::push_back(const Point &p, double time) {
+  if (capacity > 0 && window.size() == capacity) {
+    pop_front();
+  }
+  window.push_back({p, time});
+  dynamic.insert(p);
+}
+
+void SlidingWindowHull::pop_front() {
+  dynamic.erase(window.front().point);
+  window.pop_front();
+}
+
+size_t SlidingWindowHull::expire(double time) {
+  size_t dropped = 0;
+  while (!window.empty() && window.front().time < time) {
+    pop_front();
+    ++dropped;
+  }
+  return dropped;
+}
+
+void SlidingWindowHull::clear() {
+  window.clear();
+  dynamic.clear();
+}
@@ -0,0 +1,107 @@
+#include <stats.hpp>
+
+#ifdef HULL_STATS
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace stats {
+
+#ifdef HULL_STATS
+namespace detail {
+namespace {
+/* The blocks of the running threads, and the totals of the exited ones. Never
+ * destroyed: threads of static pools may exit after the static destructors. */
+struct Registry {
+  std::mutex mutex;
+  std::vector<Block *> blocks;
+  Block exited;
+};
+
+Registry &registry() {
+  static Registry *instance = new Registry;
+  return *instance;
+}
+
+void clear(Block &block) {
+  for (auto &counter : block.counters) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+  block.max_depth.store(0, std::memory_order_relaxed);
+  for (auto &counter : block.discarded_at) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+/* Add the block to the totals, where only the registry mutex writes */
+void fold(const Block &block, Block &into) {
+  for (size_t i = 0; i < Count; i++) {
+    bump(into.counters[i], block.counters[i].load(std::memory_order_relaxed));
+  }
+  into.max_depth.store(
+      std::max(into.max_depth.load(std::memory_order_relaxed),
+               block.max_depth.load(std::memory_order_relaxed)),
+      std::memory_order_relaxed);
+  for (size_t i = 0; i < levels; i++) {
+    bump(into.discarded_at[i],
+         block.discarded_at[i].load(std::memory_order_relaxed));
+  }
+}
+} // namespace
+
+Slot::Slot() : block(new Block) {
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.blocks.push_back(block);
+}
+
+Slot::~Slot() {
+  Registry &r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  fold(*block, r.exited);
+  r.blocks.erase(std::find(r.blocks.begin(), r.blocks.end(), block));
+  delete block;
+}
+} // namespace detail
+#endif
+
+void reset() {
+#ifdef HULL_STATS
+  detail::Registry &r = detail::registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  detail::clear(r.exited);
+  for (detail::Block *block : r.blocks) {
+    detail::clear(*block);
+  }
+#endif
+}
+
+Counters snapshot() {
+  Counters counters;
+#ifdef HULL_STATS
+  detail::Registry &r = detail::registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  detail::Block total;
+  detail::fold(r.exited, total);
+  for (const detail::Block *block : r.blocks) {
+    detail::fold(*block, total);
+  }
+  auto load = [&total](detail::Counter counter) {
+    return total.counters[counter].load(std::memory_order_relaxed);
+  };
+  counters.orientations = load(detail::Orientations);
+  counters.exact = load(detail::Exact);
+  counters.recursions = load(detail::Recursions);
+  counters.max_depth = total.max_depth.load(std::memory_order_relaxed);
+  counters.bridge_rounds = load(detail::BridgeRounds);
+  counters.discarded = load(detail::Discarded);
+  for (size_t i = 0; i < levels; i++) {
+    counters.discarded_at[i] =
+        total.discarded_at[i].load(std::memory_order_relaxed);
+  }
+#endif
+  return counters;
+}
+
+} // namespace stats
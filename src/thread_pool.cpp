@@ -0,0 +1,162 @@
+#include <map>
+#include <thread_pool.hpp>
+
+namespace {
+/* Pool and queue owned by the current thread, if it is a pool worker */
+thread_local ThreadPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+} // namespace
+
+ThreadPool::ThreadPool(unsigned workers) {
+  // there is always at least one queue, so that a pool without workers can
+  // still accept tasks that will be run by the waiting threads
+  size_t n_queues = workers > 0 ? workers : 1;
+  for (size_t i = 0; i < n_queues; ++i) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  for (unsigned i = 0; i < workers; ++i) {
+    threads.emplace_back([this, i] { worker_loop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stop = true;
+  }
+  sleep_cv.notify_all();
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+void ThreadPool::submit(Task task) {
+  size_t index = current_pool == this
+                     ? current_index
+                     : next_queue.fetch_add(1) % queues.size();
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back(std::move(task));
+  }
+  queued.fetch_add(1);
+
+  // take the lock so that a worker cannot miss the wake up between checking
+  // `queued` and going to sleep
+  { std::lock_guard<std::mutex> lock(sleep_mutex); }
+  sleep_cv.notify_one();
+}
+
+bool ThreadPool::pop_local(size_t index, Task &task) {
+  Queue &q = *queues[index];
+  std::lock_guard<std::mutex> lock(q.mutex);
+  if (q.tasks.empty()) {
+    return false;
+  }
+  task = std::move(q.tasks.back());
+  q.tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::steal(size_t start, Task &task) {
+  for (size_t i = 0; i < queues.size(); ++i) {
+    Queue &q = *queues[(start + i) % queues.size()];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (!q.tasks.empty()) {
+      task = std::move(q.tasks.front());
+      q.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::try_run_one() {
+  if (queued.load() == 0) {
+    return false;
+  }
+
+  Task task;
+  bool found = false;
+  if (current_pool == this) {
+    found = pop_local(current_index, task) || steal(current_index + 1, task);
+  } else {
+    found = steal(next_queue.load() % queues.size(), task);
+  }
+  if (!found) {
+    return false;
+  }
+
+  queued.fetch_sub(1);
+  task();
+  return true;
+}
+
+void ThreadPool::worker_loop(size_t index) {
+  current_pool = this;
+  current_index = index;
+
+  while (true) {
+    if (try_run_one()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    sleep_cv.wait(lock, [this] { return stop || queued.load() > 0; });
+    if (stop && queued.load() == 0) {
+      return;
+    }
+  }
+}
+
+ThreadPool &ThreadPool::shared(unsigned threads) {
+  static std::mutex mutex;
+  static std::map<unsigned, std::unique_ptr<ThreadPool>> pools;
+
+  // the thread calling wait() works too, so it is not counted as a worker
+  unsigned workers = threads > 1 ? threads - 1 : 0;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &pool = pools[workers];
+  if (!pool) {
+    pool = std::make_unique<ThreadPool>(workers);
+  }
+  return *pool;
+}
+
+TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool) {}
+
+TaskGroup::~TaskGroup() {
+  // tasks may reference the stack of the caller: never leave them behind
+  while (pending.load() > 0) {
+    if (!pool.try_run_one()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void TaskGroup::run(ThreadPool::Task task) {
+  pending.fetch_add(1);
+  pool.submit([this, task = std::move(task)] {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    pending.fetch_sub(1);
+  });
+}
+
+void TaskGroup::wait() {
+  while (pending.load() > 0) {
+    if (!pool.try_run_one()) {
+      std::this_thread::yield();
+    }
+  }
+  if (error) {
+    std::exception_ptr e = error;
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
@@ -1,35 +1,13 @@
 #include "common.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <simd.hpp>
 #include <util.hpp>
 
 namespace util {
-double sidedness(const Point &p1, const Point &p2, const Point &p3) {
-  // cast to double to avoid precision issues
-  const double dx_32 = p3.x - p2.x;
-  const double dy_12 = p1.y - p2.y;
-  const double dy_32 = p3.y - p2.y;
-  const double dx_12 = p1.x - p2.x;
-  return (dx_32 * dy_12) - (dy_32 * dx_12);
-}
-
-double sidedness(const Line &l, const Point &p) {
-  return sidedness(l.p1, l.p2, p);
-}
-
-bool isLeft(const Point &p1, const Point &p2, const Point &p3) {
-  const double dx_32 = p3.x - p2.x;
-  const double dy_12 = p1.y - p2.y;
-  const double dy_32 = p3.y - p2.y;
-  const double dx_12 = p1.x - p2.x;
-
-  return (dx_32 * dy_12) > (dy_32 * dx_12);
-
-}
-
-
-bool isLeft(const Line &l, const Point &p) { return isLeft(l.p1, l.p2, p); }
-
 bool is_inside(const Triangle &t, const Point &p) {
   /* The point must be on the same side of all the triangle's edges */
   double d1 = sidedness(t.p1, t.p2, p);
@@ -56,9 +34,9 @@ bool is_inside(const Points &polygon, const Point &p) {
     return false; // A polygon must have at least 3 vertices
   }
 
-  float initial_side = sidedness(polygon[0], polygon[1], p);
+  double initial_side = sidedness(polygon[0], polygon[1], p);
   for (size_t i = 1; i < n; ++i) {
-    float current_side = sidedness(polygon[i], polygon[(i + 1) % n], p);
+    double current_side = sidedness(polygon[i], polygon[(i + 1) % n], p);
     if (initial_side * current_side < 0) {
       return false; // Point is on the opposite side of an edge
     }
@@ -72,9 +50,9 @@ bool is_partial_inside(const Points &polygon, const Point &p) {
     return false; // A polygon must have at least 3 vertices
   }
 
-  float initial_side = sidedness(polygon[0], polygon[1], p);
+  double initial_side = sidedness(polygon[0], polygon[1], p);
   for (size_t i = 1; i < n - 1; ++i) {
-    float current_side = sidedness(polygon[i], polygon[(i + 1) % n], p);
+    double current_side = sidedness(polygon[i], polygon[(i + 1) % n], p);
     if (initial_side * current_side < 0) {
       return false; // Point is on the opposite side of an edge
     }
@@ -222,66 +200,125 @@ using TPoint = std::pair<Point, Point>;
  * rightmost_ymax)>
  */
 std::pair<TPoint, TPoint> findExtremePointsCases(const Points &points) {
-  Point leftPointYMin = points[0];
-  Point leftPointYMax = points[0];
-  Point rightPointYMin = points[0];
-  Point rightPointYMax = points[0];
+  simd::Extremes e = simd::extremes(points.data(), points.size());
+  return {{e.leftYMin, e.leftYMax}, {e.rightYMin, e.rightYMax}};
+}
 
-  for (const auto &p : points) {
-    if (p.x < leftPointYMin.x) { // new leftmost point found
-      leftPointYMin = p;
-      leftPointYMax = p;
-    } else if (p.x == leftPointYMin.x) { // same x-coordinate as current
-                                         // leftmost, check y-coordinates
-      if (p.y < leftPointYMin.y) {
-        leftPointYMin = p;
-      }
-      if (p.y > leftPointYMax.y) {
-        leftPointYMax = p;
-      }
-    }
+std::pair<TPoint, TPoint> findExtremePointsCases(const PointsSoA &points) {
+  simd::Extremes e = simd::extremes(points.xs(), points.ys(), points.size());
+  return {{e.leftYMin, e.leftYMax}, {e.rightYMin, e.rightYMax}};
+}
 
-    if (p.x > rightPointYMax.x) { // new rightmost point found
-      rightPointYMin = p;
-      rightPointYMax = p;
-    } else if (p.x == rightPointYMax.x) { // same x-coordinate as current
-                                          // rightmost, check y-coordinates
-      if (p.y < rightPointYMin.y) {
-        rightPointYMin = p;
-      }
-      if (p.y > rightPointYMax.y) {
-        rightPointYMax = p;
-      }
-    }
+std::pair<TPoint, TPoint> findExtremePointsCases(const PointsView &points) {
+  simd::Extremes e = simd::extremes(points.data(), points.size());
+  return {{e.leftYMin, e.leftYMax}, {e.rightYMin, e.rightYMax}};
+}
+
+namespace {
+Line extremesLine(const simd::Extremes &e, bool upper) {
+  // Find leftmost and rightmost points with highest (upper) or lowest
+  // (lower) y in case of ties
+  if (upper) {
+    return Line{e.leftYMax, e.rightYMax};
+  } else {
+    return Line{e.rightYMin, e.leftYMin};
   }
-  return {{leftPointYMin, leftPointYMax}, {rightPointYMin, rightPointYMax}};
 }
+} // namespace
 
 Line findExtremePoints(const Points &points, bool upper) {
-  // Find leftmost and rightmost points with highest y in case of ties
-  Point minPoint = points[0];
-  Point maxPoint = points[0];
-  if (upper) {
-    for (const auto &p : points) {
-      if (p.x < minPoint.x || (p.x == minPoint.x && p.y > minPoint.y)) {
-        minPoint = p;
-      }
-      if (p.x > maxPoint.x || (p.x == maxPoint.x && p.y > maxPoint.y)) {
-        maxPoint = p;
-      }
+  return extremesLine(simd::extremes(points.data(), points.size()), upper);
+}
+
+Line findExtremePoints(const PointsSoA &points, bool upper) {
+  return extremesLine(
+      simd::extremes(points.xs(), points.ys(), points.size()), upper);
+}
+
+Line findExtremePoints(const PointsView &points, bool upper) {
+  return extremesLine(simd::extremes(points.data(), points.size()), upper);
+}
+
+namespace {
+/* Flip a float so that its bits sort as an unsigned integer: negative values
+ * have all their bits flipped, positive ones only the sign */
+uint32_t float_key(float v) {
+  v += 0.0f; // -0.0 + 0.0 is 0.0
+  uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+} // namespace
+
+uint64_t sort_key(const Point &p) {
+  // y descending is -y ascending
+  return static_cast<uint64_t>(float_key(p.x)) << 32 | float_key(-p.y);
+}
+
+void radix_sort(Points &points) {
+  constexpr int BITS = 11;
+  constexpr int PASSES = (64 + BITS - 1) / BITS;
+  constexpr size_t BUCKETS = size_t(1) << BITS;
+  constexpr uint64_t MASK = BUCKETS - 1;
+
+  struct Item {
+    uint64_t key;
+    Point p;
+  };
+
+  const size_t n = points.size();
+  if (n < 512) {
+    // clearing the histograms would cost more than the sort itself
+    std::stable_sort(points.begin(), points.end(),
+                     [](const Point &a, const Point &b) {
+                       return sort_key(a) < sort_key(b);
+                     });
+    return;
+  }
+
+  /* All the histograms in a single pass over the keys */
+  std::vector<Item> items(n), buffer(n);
+  std::vector<size_t> counts(PASSES * BUCKETS, 0);
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t key = sort_key(points[i]);
+    items[i] = {key, points[i]};
+    for (int pass = 0; pass < PASSES; ++pass) {
+      ++counts[pass * BUCKETS + ((key >> (pass * BITS)) & MASK)];
     }
-    return Line{minPoint, maxPoint};
-  } else {
-    for (const auto &p : points) {
-      if (p.x < minPoint.x || (p.x == minPoint.x && p.y < minPoint.y)) {
-        minPoint = p;
-      }
-      if (p.x > maxPoint.x || (p.x == maxPoint.x && p.y < maxPoint.y)) {
-        maxPoint = p;
-      }
+  }
+
+  for (int pass = 0; pass < PASSES; ++pass) {
+    size_t *count = counts.data() + pass * BUCKETS;
+    const int shift = pass * BITS;
+    // every key has the same digit: this pass would not move anything
+    if (count[(items[0].key >> shift) & MASK] == n) {
+      continue;
     }
-    return Line{maxPoint, minPoint};
+
+    size_t offset = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+      size_t c = count[b];
+      count[b] = offset;
+      offset += c;
+    }
+    for (const auto &item : items) {
+      buffer[count[(item.key >> shift) & MASK]++] = item;
+    }
+    items.swap(buffer);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    points[i] = items[i].p;
+  }
+}
+
+GridPoints to_grid(const Points &points, float scale) {
+  GridPoints grid;
+  grid.reserve(points.size());
+  for (const auto &p : points) {
+    grid.emplace_back(std::lround(p.x * scale), std::lround(p.y * scale));
   }
+  return grid;
 }
 
 void print_results_comparison(const Points &grhamPoints,